@@ -0,0 +1,64 @@
+/**
+ * Base64 Benchmark
+ *
+ * Encode/decode throughput of each kernel usable on this CPU, with
+ * OpenSSL's EVP_EncodeBlock / EVP_DecodeBlock as the baseline.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "base64.h"
+#include "bench_common.h"
+
+#include <openssl/evp.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace miot;
+
+int main() {
+    const size_t sizes[] = {64, 1024, 65536};
+    for (size_t size : sizes) {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; i++) {
+            data[i] = static_cast<uint8_t>(i * 131 + 17);
+        }
+        std::string encoded = Base64::encode(data.data(), data.size());
+        std::vector<char> text(Base64::encoded_size(size) + 1);
+        std::vector<uint8_t> bytes(Base64::decoded_max_size(encoded.size()) + 1);
+        size_t iterations = 20000000 / (size + 256);
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "encode %zu B openssl", size);
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            EVP_EncodeBlock(reinterpret_cast<unsigned char*>(text.data()), data.data(), static_cast<int>(size));
+            bench::keep(text);
+        }), size);
+        std::snprintf(name, sizeof(name), "decode %zu B openssl", size);
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            EVP_DecodeBlock(bytes.data(), reinterpret_cast<const unsigned char*>(encoded.data()),
+                            static_cast<int>(encoded.size()));
+            bench::keep(bytes);
+        }), size);
+
+        for (const char* kernel : Base64::implementations()) {
+            Base64::set_implementation(kernel);
+
+            std::snprintf(name, sizeof(name), "encode %zu B %s", size, kernel);
+            bench::report(name, bench::ns_per_op(iterations, [&] {
+                Base64::encode(data.data(), size, text.data());
+                bench::keep(text);
+            }), size);
+            std::snprintf(name, sizeof(name), "decode %zu B %s", size, kernel);
+            bench::report(name, bench::ns_per_op(iterations, [&] {
+                size_t out_len = 0;
+                Base64::decode(encoded.data(), encoded.size(), bytes.data(), out_len);
+                bench::keep(out_len);
+            }), size);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * CloudCrypto Benchmark
+ *
+ * Compares the cached CloudCrypto contexts against the per-call setup they
+ * replaced: a fresh EVP_CIPHER_CTX with the key set on every request, and
+ * the PEM public key parsed on every RSA encryption.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "cloud_crypto.h"
+#include "bench_common.h"
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/bio.h>
+#include <openssl/rsa.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace miot;
+
+namespace {
+
+// Generate a throwaway 2048-bit RSA public key in PEM form
+std::string make_public_key_pem() {
+    std::string pem;
+    EVP_PKEY* pkey = nullptr;
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr);
+    if (ctx && EVP_PKEY_keygen_init(ctx) > 0 &&
+        EVP_PKEY_CTX_set_rsa_keygen_bits(ctx, 2048) > 0 &&
+        EVP_PKEY_keygen(ctx, &pkey) > 0) {
+        BIO* bio = BIO_new(BIO_s_mem());
+        if (bio && PEM_write_bio_PUBKEY(bio, pkey) == 1) {
+            char* data = nullptr;
+            long len = BIO_get_mem_data(bio, &data);
+            pem.assign(data, static_cast<size_t>(len));
+        }
+        BIO_free(bio);
+    }
+    EVP_PKEY_free(pkey);
+    EVP_PKEY_CTX_free(ctx);
+    return pem;
+}
+
+// Per-call AES-128-CBC as before CloudCrypto: new context and key schedule every time
+bool legacy_encrypt(const std::vector<uint8_t>& key, const uint8_t* data, size_t len, std::vector<uint8_t>& out) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+    out.resize(CloudCrypto::padded_size(len));
+    int written = 0;
+    int final_len = 0;
+    bool ok = EVP_EncryptInit_ex(ctx, EVP_aes_128_cbc(), nullptr, key.data(), key.data()) == 1 &&
+              EVP_EncryptUpdate(ctx, out.data(), &written, data, static_cast<int>(len)) == 1 &&
+              EVP_EncryptFinal_ex(ctx, out.data() + written, &final_len) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    out.resize(ok ? written + final_len : 0);
+    return ok;
+}
+
+bool legacy_decrypt(const std::vector<uint8_t>& key, const uint8_t* data, size_t len, std::vector<uint8_t>& out) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx) {
+        return false;
+    }
+    out.resize(len);
+    int written = 0;
+    int final_len = 0;
+    bool ok = EVP_DecryptInit_ex(ctx, EVP_aes_128_cbc(), nullptr, key.data(), key.data()) == 1 &&
+              EVP_CIPHER_CTX_set_padding(ctx, 0) == 1 &&
+              EVP_DecryptUpdate(ctx, out.data(), &written, data, static_cast<int>(len)) == 1 &&
+              EVP_DecryptFinal_ex(ctx, out.data() + written, &final_len) == 1;
+    EVP_CIPHER_CTX_free(ctx);
+    out.resize(ok ? written + final_len : 0);
+    if (ok && !out.empty() && out.back() <= CloudCrypto::BLOCK_SIZE) {
+        out.resize(out.size() - out.back());
+    }
+    return ok;
+}
+
+// Per-call RSA as before CloudCrypto: parse the PEM key for every encryption
+std::vector<uint8_t> legacy_rsa_encrypt(const std::string& pem, const uint8_t* data, size_t len) {
+    std::vector<uint8_t> result;
+    BIO* bio = BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size()));
+    EVP_PKEY* pkey = bio ? PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr) : nullptr;
+    BIO_free(bio);
+    if (!pkey) {
+        return result;
+    }
+
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new(pkey, nullptr);
+    size_t outlen = 0;
+    if (ctx && EVP_PKEY_encrypt_init(ctx) > 0 &&
+        EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_PADDING) > 0 &&
+        EVP_PKEY_encrypt(ctx, nullptr, &outlen, data, len) > 0) {
+        result.resize(outlen);
+        if (EVP_PKEY_encrypt(ctx, result.data(), &outlen, data, len) > 0) {
+            result.resize(outlen);
+        } else {
+            result.clear();
+        }
+    }
+    EVP_PKEY_CTX_free(ctx);
+    EVP_PKEY_free(pkey);
+    return result;
+}
+
+} // anonymous namespace
+
+int main() {
+    std::string pem = make_public_key_pem();
+    CloudCrypto crypto;
+    if (pem.empty() || !crypto.init(pem.c_str())) {
+        std::fprintf(stderr, "Failed to set up RSA key\n");
+        return 1;
+    }
+    const std::vector<uint8_t>& key = crypto.key();
+
+    const size_t sizes[] = {64, 1024, 16384};
+    for (size_t size : sizes) {
+        std::vector<uint8_t> plain(size);
+        for (size_t i = 0; i < size; i++) {
+            plain[i] = static_cast<uint8_t>(i * 31 + 7);
+        }
+
+        // Both paths must produce the same bytes before their speed means anything
+        std::vector<uint8_t> cached_out;
+        std::vector<uint8_t> legacy_out;
+        std::vector<uint8_t> round_trip;
+        if (!crypto.encrypt(plain.data(), size, cached_out) ||
+            !legacy_encrypt(key, plain.data(), size, legacy_out) || cached_out != legacy_out ||
+            !crypto.decrypt(cached_out.data(), cached_out.size(), round_trip) || round_trip != plain) {
+            std::fprintf(stderr, "Cached and per-call AES disagree at %zu bytes\n", size);
+            return 1;
+        }
+
+        size_t iterations = 2000000 / (size / 64 + 8);
+        std::vector<uint8_t> out;
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "encrypt %zu B per-call ctx", size);
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            legacy_encrypt(key, plain.data(), size, out);
+            bench::keep(out);
+        }), size);
+        std::snprintf(name, sizeof(name), "encrypt %zu B cached ctx", size);
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            crypto.encrypt(plain.data(), size, out);
+            bench::keep(out);
+        }), size);
+        std::snprintf(name, sizeof(name), "decrypt %zu B per-call ctx", size);
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            legacy_decrypt(key, cached_out.data(), cached_out.size(), out);
+            bench::keep(out);
+        }), size);
+        std::snprintf(name, sizeof(name), "decrypt %zu B cached ctx", size);
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            crypto.decrypt(cached_out.data(), cached_out.size(), out);
+            bench::keep(out);
+        }), size);
+    }
+
+    // RSA wraps the 16-byte session key once per client secret
+    const size_t rsa_iterations = 2000;
+    if (legacy_rsa_encrypt(pem, key.data(), key.size()).empty() ||
+        crypto.rsa_encrypt(key.data(), key.size()).empty()) {
+        std::fprintf(stderr, "RSA encryption failed\n");
+        return 1;
+    }
+    bench::report("rsa_encrypt PEM parsed per call", bench::ns_per_op(rsa_iterations, [&] {
+        bench::keep(legacy_rsa_encrypt(pem, key.data(), key.size()));
+    }));
+    bench::report("rsa_encrypt cached public key", bench::ns_per_op(rsa_iterations, [&] {
+        bench::keep(crypto.rsa_encrypt(key.data(), key.size()));
+    }));
+    return 0;
+}
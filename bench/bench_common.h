@@ -0,0 +1,59 @@
+/**
+ * Benchmark Helpers
+ *
+ * Minimal timing helpers shared by the bench_* executables.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace miot {
+namespace bench {
+
+/**
+ * @brief Keep a value alive so the compiler cannot drop the work producing it
+ */
+template <typename T>
+inline void keep(const T& value) {
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief Run fn iterations times (after a short warm-up) and return ns per call
+ */
+template <typename Fn>
+double ns_per_op(size_t iterations, Fn&& fn) {
+    for (size_t i = 0; i < iterations / 10 + 1; i++) {
+        fn();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fn();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+/**
+ * @brief Print one result row: name, ns/op and, if bytes is set, MB/s
+ */
+inline void report(const char* name, double ns, size_t bytes = 0) {
+    if (bytes) {
+        std::printf("%-40s %12.1f ns/op %10.1f MB/s\n", name, ns, bytes * 1000.0 / ns);
+    } else {
+        std::printf("%-40s %12.1f ns/op\n", name, ns);
+    }
+}
+
+} // namespace bench
+} // namespace miot
+
+#endif // BENCH_COMMON_H
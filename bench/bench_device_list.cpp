@@ -0,0 +1,229 @@
+/**
+ * Device List Parser Benchmark
+ *
+ * Throughput of the single-pass device_list_page scanner against the
+ * substring-search parser it replaced (kept here as a copy), and against
+ * building an nlohmann::json DOM and reading the same fields from it.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "miot_cloud_client.h"
+#include "bench_common.h"
+
+#include <nlohmann/json.hpp>
+
+#include <cctype>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace miot;
+
+namespace {
+
+// A response shaped like the cloud's: per-device extra/owner objects plus fields nobody reads
+std::string make_response(size_t device_count) {
+    std::string list;
+    for (size_t i = 0; i < device_count; i++) {
+        std::string did = std::to_string(100000000 + i * 7919);
+        list += i ? "," : "";
+        list += "{\"did\":\"" + did + "\",\"name\":\"Camera \\\"" + std::to_string(i) +
+                "\\\" \\u5ba2\\u5385 \\ud83d\\udcf7\",\"model\":\"chuangmi.camera.v" + std::to_string(i % 10) +
+                "\",\"spec_type\":\"urn:miot-spec-v2:device:camera:0000A01C:chuangmi-v1:1\","
+                "\"token\":\"0123456789abcdef0123456789abcdef\",\"uid\":1234567890,\"isOnline\":true,"
+                "\"local_ip\":\"192.168.1." + std::to_string(i % 250) + "\",\"ssid\":\"home-wifi\","
+                "\"bssid\":\"AA:BB:CC:DD:EE:FF\",\"rssi\":-" + std::to_string(40 + i % 50) + ","
+                "\"longitude\":\"0.0\",\"latitude\":\"0.0\",\"pid\":0,\"permitLevel\":16,"
+                "\"method\":[{\"allow_values\":\"\",\"name\":\"set_power\"}],"
+                "\"extra\":{\"isSetPincode\":0,\"pincodeType\":0,\"fw_version\":\"4.1.6_1999\","
+                "\"needVerifyCode\":0,\"isPasswordEncrypt\":0,\"mcu_version\":\"0001\",\"platform\":\"ingenic\"},"
+                "\"owner\":{\"userid\":987654321,\"nickname\":\"owner\",\"icon\":\"https://example.com/a.jpg\"}}";
+    }
+    return "{\"code\":0,\"message\":\"ok\",\"result\":{\"list\":[" + list +
+           "],\"has_more\":false,\"next_start_did\":\"\"}}";
+}
+
+// The parser before the scanner, verbatim apart from being free functions
+namespace legacy {
+
+std::string extract_string(const std::string& json, const std::string& key) {
+    std::string search_key = "\"" + key + "\":\"";
+    size_t pos = json.find(search_key);
+    if (pos == std::string::npos) {
+        return "";
+    }
+    
+    pos += search_key.length();
+    size_t end_pos = json.find("\"", pos);
+    if (end_pos == std::string::npos) {
+        return "";
+    }
+    
+    return json.substr(pos, end_pos - pos);
+}
+
+int extract_int(const std::string& json, const std::string& key) {
+    std::string search_key = "\"" + key + "\":";
+    size_t pos = json.find(search_key);
+    if (pos == std::string::npos) {
+        return 0;
+    }
+    
+    pos += search_key.length();
+    size_t end_pos = pos;
+    while (end_pos < json.length() && (std::isdigit(json[end_pos]) || json[end_pos] == '-')) {
+        end_pos++;
+    }
+    
+    if (end_pos == pos) {
+        return 0;
+    }
+    
+    try {
+        return std::stoi(json.substr(pos, end_pos - pos));
+    } catch (...) {
+        return 0;
+    }
+}
+
+bool extract_bool(const std::string& json, const std::string& key) {
+    std::string search_key = "\"" + key + "\":";
+    size_t pos = json.find(search_key);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    
+    pos += search_key.length();
+    return json.substr(pos, 4) == "true";
+}
+
+std::map<std::string, CloudDeviceInfo> parse_device_list_response(const std::string& json) {
+    std::map<std::string, CloudDeviceInfo> devices;
+    
+    // Find the "list" array
+    size_t list_pos = json.find("\"list\":[");
+    if (list_pos == std::string::npos) {
+        std::cerr << "[SimpleJson] No 'list' found in response" << std::endl;
+        return devices;
+    }
+    
+    size_t pos = list_pos + 8;  // Skip "\"list\":["
+    
+    // Parse each device object
+    while (pos < json.length()) {
+        // Find next device object
+        size_t obj_start = json.find("{", pos);
+        if (obj_start == std::string::npos) {
+            break;
+        }
+        
+        // Find matching closing brace
+        int brace_count = 1;
+        size_t obj_end = obj_start + 1;
+        while (obj_end < json.length() && brace_count > 0) {
+            if (json[obj_end] == '{') brace_count++;
+            else if (json[obj_end] == '}') brace_count--;
+            obj_end++;
+        }
+        
+        if (brace_count != 0) {
+            break;
+        }
+        
+        std::string device_json = json.substr(obj_start, obj_end - obj_start);
+        
+        CloudDeviceInfo info;
+        info.did = extract_string(device_json, "did");
+        info.name = extract_string(device_json, "name");
+        info.model = extract_string(device_json, "model");
+        info.urn = extract_string(device_json, "spec_type");
+        info.token = extract_string(device_json, "token");
+        info.uid = extract_string(device_json, "uid");
+        info.online = extract_bool(device_json, "isOnline");
+        info.local_ip = extract_string(device_json, "local_ip");
+        info.ssid = extract_string(device_json, "ssid");
+        info.bssid = extract_string(device_json, "bssid");
+        info.rssi = extract_int(device_json, "rssi");
+        
+        if (!info.did.empty() && !info.model.empty()) {
+            // Extract manufacturer from model (e.g., "xiaomi.camera.082ac1" -> "xiaomi")
+            size_t dot_pos = info.model.find('.');
+            if (dot_pos != std::string::npos) {
+                info.manufacturer = info.model.substr(0, dot_pos);
+            }
+            
+            devices[info.did] = info;
+        }
+        
+        pos = obj_end;
+    }
+    
+    return devices;
+}
+
+} // namespace legacy
+
+std::map<std::string, CloudDeviceInfo> nlohmann_parse(const std::string& json) {
+    std::map<std::string, CloudDeviceInfo> devices;
+    nlohmann::json document = nlohmann::json::parse(json);
+    for (const auto& item : document["result"]["list"]) {
+        CloudDeviceInfo info;
+        info.did = item.value("did", "");
+        info.name = item.value("name", "");
+        info.model = item.value("model", "");
+        info.urn = item.value("spec_type", "");
+        info.token = item.value("token", "");
+        info.uid = std::to_string(item.value("uid", int64_t(0)));
+        info.online = item.value("isOnline", false);
+        info.local_ip = item.value("local_ip", "");
+        info.ssid = item.value("ssid", "");
+        info.bssid = item.value("bssid", "");
+        info.rssi = item.value("rssi", 0);
+        const auto& extra = item["extra"];
+        info.fw_version = extra.value("fw_version", "");
+        info.mcu_version = extra.value("mcu_version", "");
+        info.platform = extra.value("platform", "");
+        info.is_set_pincode = extra.value("isSetPincode", 0);
+        info.pincode_type = extra.value("pincodeType", 0);
+        const auto& owner = item["owner"];
+        info.owner_id = std::to_string(owner.value("userid", int64_t(0)));
+        info.owner_nickname = owner.value("nickname", "");
+        info.manufacturer = info.model.substr(0, info.model.find('.'));
+        devices[info.did] = std::move(info);
+    }
+    return devices;
+}
+
+} // anonymous namespace
+
+int main() {
+    const size_t counts[] = {1, 50, 300};
+    for (size_t count : counts) {
+        std::string json = make_response(count);
+        if (SimpleJson::parse_device_list_response(json).size() != count ||
+            legacy::parse_device_list_response(json).size() != count ||
+            nlohmann_parse(json).size() != count) {
+            std::fprintf(stderr, "Parsers disagree on %zu devices\n", count);
+            return 1;
+        }
+
+        size_t iterations = 20000 / count + 50;
+        char name[64];
+        std::snprintf(name, sizeof(name), "%zu devices (%zu B) scanner", count, json.size());
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            bench::keep(SimpleJson::parse_device_list_response(json));
+        }), json.size());
+        std::snprintf(name, sizeof(name), "%zu devices (%zu B) old substring", count, json.size());
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            bench::keep(legacy::parse_device_list_response(json));
+        }), json.size());
+        std::snprintf(name, sizeof(name), "%zu devices (%zu B) nlohmann DOM", count, json.size());
+        bench::report(name, bench::ns_per_op(iterations, [&] {
+            bench::keep(nlohmann_parse(json));
+        }), json.size());
+    }
+    return 0;
+}
@@ -0,0 +1,203 @@
+/**
+ * LAN Discovery Receive Benchmark
+ *
+ * Binds a MIoTLanDiscovery instance to the loopback interface, blasts OTU
+ * probe replies mixed with junk datagrams at its socket, and reports how
+ * many datagrams per second the discovery loop drains. Datagrams the
+ * kernel dropped on a full receive buffer are not counted. Linux only.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "miot_lan_device.h"
+#include "bench_common.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <poll.h>
+    #include <unistd.h>
+#endif
+
+using namespace miot;
+
+#ifdef __linux__
+
+namespace {
+
+const uint16_t OT_PORT = 54321;
+const size_t DEVICE_COUNT = 200;
+const size_t DATAGRAMS = 1000000;
+
+// Kernel-wide count of UDP datagrams dropped on a full receive buffer
+uint64_t udp_rcvbuf_errors() {
+    std::ifstream snmp("/proc/net/snmp");
+    std::string header;
+    std::string values;
+    while (std::getline(snmp, header) && std::getline(snmp, values)) {
+        if (header.compare(0, 4, "Udp:") != 0) {
+            continue;
+        }
+        std::istringstream names(header);
+        std::istringstream numbers(values);
+        std::string name;
+        std::string number;
+        while (names >> name && numbers >> number) {
+            if (name == "RcvbufErrors") {
+                return std::stoull(number);
+            }
+        }
+    }
+    return 0;
+}
+
+// Bytes still queued on the UDP socket bound to port
+uint64_t udp_rx_queue(uint16_t port) {
+    std::ifstream udp("/proc/net/udp");
+    std::string line;
+    std::getline(udp, line);
+    while (std::getline(udp, line)) {
+        unsigned local_port = 0;
+        unsigned long tx_queue = 0;
+        unsigned long rx_queue = 0;
+        if (std::sscanf(line.c_str(), " %*d: %*x:%x %*x:%*x %*x %lx:%lx",
+                        &local_port, &tx_queue, &rx_queue) == 3 && local_port == port) {
+            return rx_queue;
+        }
+    }
+    return 0;
+}
+
+int bound_socket(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 32-byte OTU probe reply: "!1", length, DID, timestamp
+void make_reply(uint8_t* msg, uint64_t did) {
+    std::memset(msg, 0, 32);
+    msg[0] = 0x21;
+    msg[1] = 0x31;
+    msg[3] = 32;
+    for (int i = 0; i < 8; i++) {
+        msg[4 + i] = static_cast<uint8_t>(did >> (56 - 8 * i));
+    }
+    msg[15] = 1;
+}
+
+} // anonymous namespace
+
+int main() {
+    // Replies must come from the OTU port, like real devices
+    int device_fd = bound_socket(OT_PORT);
+    int stranger_fd = bound_socket(0);
+    if (device_fd < 0 || stranger_fd < 0) {
+        std::fprintf(stderr, "Cannot bind 127.0.0.1:%u\n", OT_PORT);
+        return 1;
+    }
+
+    MIoTLanDiscovery discovery({"lo"});
+    if (!discovery.start()) {
+        std::fprintf(stderr, "Failed to start discovery on lo\n");
+        return 1;
+    }
+
+    // A unicast ping tells us which port the discovery socket is bound to
+    struct sockaddr_in target;
+    socklen_t target_len = sizeof(target);
+    uint8_t probe[1500];
+    discovery.ping("lo", "127.0.0.1");
+    struct pollfd pfd = {device_fd, POLLIN, 0};
+    if (poll(&pfd, 1, 2000) <= 0 ||
+        recvfrom(device_fd, probe, sizeof(probe), 0, reinterpret_cast<struct sockaddr*>(&target), &target_len) < 0) {
+        std::fprintf(stderr, "No probe received from the discovery socket\n");
+        return 1;
+    }
+    uint16_t port = ntohs(target.sin_port);
+
+    // Junk: bad header, truncated reply, and a valid reply from a non-OTU port
+    uint8_t bad_header[32];
+    make_reply(bad_header, 1);
+    bad_header[1] = 0x32;
+    uint8_t reply[32];
+
+    uint64_t dropped_before = udp_rcvbuf_errors();
+    size_t replies = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < DATAGRAMS; i++) {
+        const auto* dest = reinterpret_cast<const struct sockaddr*>(&target);
+        switch (i % 4) {
+            case 0:
+            case 1:
+                make_reply(reply, 1000000 + replies % DEVICE_COUNT);
+                sendto(device_fd, reply, sizeof(reply), 0, dest, sizeof(target));
+                replies++;
+                break;
+            case 2:
+                sendto(device_fd, (i & 4) ? bad_header : reply, (i & 4) ? sizeof(bad_header) : 12, 0,
+                       dest, sizeof(target));
+                break;
+            default:
+                sendto(stranger_fd, reply, sizeof(reply), 0, dest, sizeof(target));
+                break;
+        }
+    }
+    auto sent = std::chrono::steady_clock::now();
+    while (udp_rx_queue(port) > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    auto drained = std::chrono::steady_clock::now();
+
+    uint64_t dropped = udp_rcvbuf_errors() - dropped_before;
+    uint64_t delivered = dropped < DATAGRAMS ? DATAGRAMS - dropped : 0;
+    double seconds = std::chrono::duration<double>(drained - start).count();
+    double send_seconds = std::chrono::duration<double>(sent - start).count();
+
+    std::printf("sent %zu datagrams (%zu OTU replies from %zu devices) in %.3f s\n",
+                DATAGRAMS, replies, DEVICE_COUNT, send_seconds);
+    std::printf("delivered %llu, dropped on full receive buffer %llu\n",
+                static_cast<unsigned long long>(delivered), static_cast<unsigned long long>(dropped));
+    bench::report("discovery receive (per datagram)", seconds * 1e9 / static_cast<double>(delivered));
+    std::printf("%-40s %12.0f datagrams/s\n", "discovery receive rate", delivered / seconds);
+
+    size_t known = discovery.get_device_count();
+    discovery.stop();
+    close(device_fd);
+    close(stranger_fd);
+
+    if (known != DEVICE_COUNT) {
+        std::fprintf(stderr, "Expected %zu devices, discovery knows %zu\n", DEVICE_COUNT, known);
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    std::printf("bench_lan_discovery needs Linux (epoll/recvmmsg receive path)\n");
+    return 0;
+}
+
+#endif
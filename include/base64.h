@@ -0,0 +1,81 @@
+/**
+ * Base64 Codec
+ *
+ * Standard alphabet (RFC 4648) base64 with SIMD kernels picked at runtime:
+ * AVX2 or SSSE3 on x86, NEON on AArch64, portable scalar code elsewhere.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef BASE64_H
+#define BASE64_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace miot {
+
+/**
+ * @brief Base64 encoder/decoder
+ */
+class Base64 {
+public:
+    /**
+     * @brief Encoded length of len bytes (with '=' padding)
+     */
+    static size_t encoded_size(size_t len) { return (len + 2) / 3 * 4; }
+
+    /**
+     * @brief Upper bound of the decoded length of len characters
+     */
+    static size_t decoded_max_size(size_t len) { return (len + 3) / 4 * 3; }
+
+    /**
+     * @brief Encode into out, which must hold encoded_size(len) characters
+     */
+    static void encode(const uint8_t* data, size_t len, char* out);
+
+    /**
+     * @brief Encode to a string
+     */
+    static std::string encode(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Decode into out, which must hold decoded_max_size(len) bytes
+     *
+     * Padding is optional and trailing whitespace is ignored; any other
+     * character outside the alphabet fails the decode.
+     *
+     * @param out_len Set to the number of decoded bytes
+     * @return true if the input is valid base64
+     */
+    static bool decode(const char* data, size_t len, uint8_t* out, size_t& out_len);
+
+    /**
+     * @brief Decode into a buffer, replacing its contents (empty on failure)
+     */
+    static bool decode(const std::string& encoded, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Name of the kernel in use ("avx2", "ssse3", "neon" or "scalar")
+     */
+    static const char* implementation();
+
+    /**
+     * @brief Kernels usable on this CPU, fastest first ("scalar" is always last)
+     */
+    static std::vector<const char*> implementations();
+
+    /**
+     * @brief Switch every caller to the named kernel (for tests and benchmarks)
+     * @return false if the kernel is not built in or not supported by this CPU
+     */
+    static bool set_implementation(const char* name);
+};
+
+} // namespace miot
+
+#endif // BASE64_H
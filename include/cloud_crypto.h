@@ -0,0 +1,98 @@
+/**
+ * Cloud Crypto Context
+ *
+ * Session crypto for the MIoT cloud API: an RSA-wrapped random AES-128 key
+ * and AES-CBC request/response encryption, with the parsed public key and
+ * the cipher contexts kept for the life of the session.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef CLOUD_CRYPTO_H
+#define CLOUD_CRYPTO_H
+
+#include <openssl/evp.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <mutex>
+
+namespace miot {
+
+/**
+ * @brief Reusable crypto context for one cloud session
+ *
+ * The key schedule is set up once in init(); each call only resets the IV,
+ * so OpenSSL's EVP path (AES-NI / ARMv8 crypto extensions when available)
+ * does the work. encrypt() and decrypt() are thread-safe.
+ */
+class CloudCrypto {
+public:
+    static constexpr size_t KEY_SIZE = 16;
+    static constexpr size_t BLOCK_SIZE = 16;
+
+    CloudCrypto();
+    ~CloudCrypto();
+
+    // Disable copy
+    CloudCrypto(const CloudCrypto&) = delete;
+    CloudCrypto& operator=(const CloudCrypto&) = delete;
+
+    /**
+     * @brief Parse the server public key and generate a fresh session key
+     * @param public_key_pem PEM encoded RSA public key
+     * @return true on success
+     */
+    bool init(const char* public_key_pem);
+
+    /**
+     * @brief Session AES key (empty before init)
+     */
+    const std::vector<uint8_t>& key() const { return key_; }
+
+    /**
+     * @brief RSA (PKCS#1 v1.5) encrypt with the server public key
+     * @return Ciphertext, empty on failure
+     */
+    std::vector<uint8_t> rsa_encrypt(const uint8_t* data, size_t len) const;
+
+    /**
+     * @brief AES-128-CBC encrypt with PKCS#7 padding (IV = key)
+     * @param out Replaced by the ciphertext
+     * @return true on success
+     */
+    bool encrypt(const uint8_t* data, size_t len, std::vector<uint8_t>& out);
+
+    /**
+     * @brief AES-128-CBC decrypt and strip PKCS#7 padding
+     *
+     * Like the reference implementation, a bad padding byte leaves the
+     * plaintext as is instead of failing.
+     *
+     * @param out Replaced by the plaintext
+     * @return true on success
+     */
+    bool decrypt(const uint8_t* data, size_t len, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Upper bound of encrypt() output for len bytes of input
+     */
+    static size_t padded_size(size_t len) { return (len / BLOCK_SIZE + 1) * BLOCK_SIZE; }
+
+private:
+    std::vector<uint8_t> key_;
+    EVP_PKEY* public_key_;
+
+    EVP_CIPHER_CTX* encrypt_ctx_;
+    EVP_CIPHER_CTX* decrypt_ctx_;
+    std::mutex encrypt_mutex_;
+    std::mutex decrypt_mutex_;
+
+    void reset();
+};
+
+} // namespace miot
+
+#endif // CLOUD_CRYPTO_H
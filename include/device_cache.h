@@ -0,0 +1,98 @@
+/**
+ * Device Cache
+ *
+ * On-disk snapshot of discovered devices (LAN address plus cloud metadata),
+ * so a restarted bridge can probe known devices directly and bring cameras
+ * back without waiting for a discovery cycle and a cloud round trip.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef DEVICE_CACHE_H
+#define DEVICE_CACHE_H
+
+#include "miot_lan_device.h"
+#include "miot_cloud_client.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <cstdint>
+
+namespace miot {
+
+/**
+ * @brief One cached device
+ */
+struct CachedDevice {
+    std::string did;
+    std::string ip;
+    std::string interface;
+    int64_t timestamp_offset = 0;
+    int64_t last_seen = 0;              // Unix time of the last LAN update
+    bool has_cloud_info = false;
+    CloudDeviceInfo cloud_info;         // Only the persisted fields are set
+};
+
+/**
+ * @brief Persistent device snapshot
+ *
+ * Every change to an address or to the cloud metadata rewrites the file
+ * atomically (temporary file, fsync, rename), so a crash leaves either the
+ * old or the new snapshot. Secrets such as the device token are not stored.
+ * All methods are thread-safe.
+ */
+class DeviceCache {
+public:
+    /**
+     * @brief Constructor
+     * @param path Snapshot file
+     */
+    explicit DeviceCache(const std::string& path);
+
+    /**
+     * @brief Load the snapshot (a missing file is an empty cache)
+     * @return false if the file exists but cannot be parsed
+     */
+    bool load();
+
+    /**
+     * @brief All cached devices
+     */
+    std::vector<CachedDevice> get_devices() const;
+
+    /**
+     * @brief Cached cloud metadata of a device
+     * @return false if the device has none
+     */
+    bool get_cloud_info(const std::string& did, CloudDeviceInfo& info) const;
+
+    /**
+     * @brief Record the LAN address of a device, saving if it changed
+     */
+    void update_lan(const DeviceInfo& info);
+
+    /**
+     * @brief Record the cloud metadata of a device, saving if it changed
+     */
+    void update_cloud(const CloudDeviceInfo& info);
+
+    /**
+     * @brief Write the snapshot now
+     * @return true on success
+     */
+    bool save();
+
+private:
+    std::string path_;
+    std::map<std::string, CachedDevice> devices_;
+    mutable std::mutex mutex_;
+
+    bool save_locked();
+};
+
+} // namespace miot
+
+#endif // DEVICE_CACHE_H
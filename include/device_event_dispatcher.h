@@ -0,0 +1,127 @@
+/**
+ * Device Event Dispatcher
+ *
+ * Runs device status callbacks on a small worker pool so that slow handlers
+ * (cloud lookups, camera start) never stall discovery or timeout checks.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef DEVICE_EVENT_DISPATCHER_H
+#define DEVICE_EVENT_DISPATCHER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+namespace miot {
+
+/**
+ * @brief Dispatcher metrics snapshot
+ */
+struct DeviceEventStats {
+    uint64_t posted = 0;             // Events accepted
+    uint64_t dispatched = 0;         // Events whose handler has returned
+    size_t queue_depth = 0;          // Events waiting across all workers
+    size_t max_queue_depth = 0;      // Highest queue depth observed
+    uint64_t avg_wait_us = 0;        // Mean time from post to handler start
+    uint64_t avg_handler_us = 0;     // Mean handler run time
+    uint64_t max_handler_us = 0;     // Slowest handler run time
+};
+
+/**
+ * @brief Per-device ordered event dispatcher
+ *
+ * Each DID is hashed to one worker, so events for the same device run in the
+ * order they were posted while different devices are handled in parallel.
+ */
+class DeviceEventDispatcher {
+public:
+    using Event = std::function<void()>;
+
+    /**
+     * @brief Constructor
+     * @param worker_count Number of worker threads (at least 1)
+     */
+    explicit DeviceEventDispatcher(size_t worker_count = 4);
+
+    /**
+     * @brief Destructor, stops the workers
+     */
+    ~DeviceEventDispatcher();
+
+    // Disable copy
+    DeviceEventDispatcher(const DeviceEventDispatcher&) = delete;
+    DeviceEventDispatcher& operator=(const DeviceEventDispatcher&) = delete;
+
+    /**
+     * @brief Set the number of worker threads (takes effect on next start)
+     * @param worker_count Number of worker threads (at least 1)
+     */
+    void set_worker_count(size_t worker_count);
+
+    /**
+     * @brief Start the worker threads
+     */
+    void start();
+
+    /**
+     * @brief Stop the workers after the events already queued have run
+     */
+    void stop();
+
+    /**
+     * @brief Queue an event for a device
+     * @param did Device ID, events with the same DID run in order
+     * @param event Handler to run on a worker thread
+     * @return false if the dispatcher is not running
+     */
+    bool post(const std::string& did, Event event);
+
+    /**
+     * @brief Get current metrics
+     */
+    DeviceEventStats get_stats() const;
+
+private:
+    struct PendingEvent {
+        Event event;
+        std::chrono::steady_clock::time_point posted_at;
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<PendingEvent> queue;
+        bool stopping = false;
+    };
+
+    size_t worker_count_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_;
+    mutable std::mutex lifecycle_mutex_;
+
+    // Metrics
+    std::atomic<uint64_t> posted_;
+    std::atomic<uint64_t> dispatched_;
+    std::atomic<size_t> queue_depth_;
+    std::atomic<size_t> max_queue_depth_;
+    std::atomic<uint64_t> total_wait_us_;
+    std::atomic<uint64_t> total_handler_us_;
+    std::atomic<uint64_t> max_handler_us_;
+
+    void worker_loop(Worker& worker);
+};
+
+} // namespace miot
+
+#endif // DEVICE_EVENT_DISPATCHER_H
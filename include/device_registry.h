@@ -0,0 +1,137 @@
+/**
+ * Device Registry
+ *
+ * Table of LAN devices keyed by the numeric DID, built for large flat
+ * networks: lookups are spread over independently locked shards, and
+ * readers take an immutable snapshot without touching any shard lock.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef DEVICE_REGISTRY_H
+#define DEVICE_REGISTRY_H
+
+#include "miot_lan_device.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace miot {
+
+/**
+ * @brief Sharded open-addressing device table
+ *
+ * Each shard is a linear-probing hash table from DID to a dense entry
+ * array, so probing only touches 16-byte slots. Devices are never
+ * removed (an unreachable device is marked offline), which keeps the
+ * probing free of tombstones.
+ *
+ * snapshot() is rebuilt lazily: status changes only bump a version, and the
+ * first reader after a change copies the shards once. Readers in between
+ * share the same published snapshot. Heartbeats that change nothing but
+ * last_seen and timestamp_offset do not invalidate it.
+ */
+class DeviceRegistry {
+public:
+    /**
+     * @brief Constructor
+     * @param shard_count Number of independently locked shards (rounded up to a power of two)
+     */
+    explicit DeviceRegistry(size_t shard_count = 16);
+
+    // Disable copy
+    DeviceRegistry(const DeviceRegistry&) = delete;
+    DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+    /**
+     * @brief Record a probe reply from a device
+     * @param did Device ID
+     * @param ip_addr IPv4 address in network byte order
+     * @param interface_name Interface the reply arrived on
+     * @param timestamp_offset Offset of the device clock
+     * @param now Receive time
+     * @param changed Filled with the device state if its status changed
+     * @return true if the device is new or its status changed
+     */
+    bool update(uint64_t did, uint32_t ip_addr, const std::string& interface_name,
+                int64_t timestamp_offset, std::chrono::steady_clock::time_point now,
+                DeviceInfo& changed);
+
+    /**
+     * @brief Look up one device
+     * @return false if the device is unknown
+     */
+    bool find(uint64_t did, DeviceInfo& info) const;
+
+    /**
+     * @brief Mark one device offline if it has not been seen since cutoff
+     * @param did Device ID
+     * @param cutoff Latest last_seen that still counts as idle
+     * @param info Filled with the device state (left default if unknown)
+     * @return true if the device went offline
+     */
+    bool expire_if_idle(uint64_t did, std::chrono::steady_clock::time_point cutoff, DeviceInfo& info);
+
+    /**
+     * @brief Current snapshot (last_seen is as of the last status change)
+     */
+    std::shared_ptr<const DeviceSnapshot> snapshot() const;
+
+    /**
+     * @brief Copy every device as it is now, locking one shard at a time like find()
+     *
+     * Unlike snapshot() this always copies, but last_seen and
+     * timestamp_offset are current.
+     */
+    DeviceSnapshot collect() const;
+
+    /**
+     * @brief Number of known devices
+     */
+    size_t size() const;
+
+private:
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    struct Slot {
+        uint64_t did;
+        uint32_t entry;     // Index into entries, EMPTY_SLOT if unused
+    };
+
+    struct Entry {
+        DeviceInfo info;
+        uint32_t ip_addr;   // Network byte order, compared instead of info.ip
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::vector<Slot> slots;        // Power-of-two capacity, at most 3/4 full
+        std::vector<Entry> entries;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t shard_mask_;
+    std::atomic<size_t> size_;
+
+    // Bumped on every status change; the snapshot records the version it was built from
+    std::atomic<uint64_t> version_;
+    mutable std::mutex snapshot_mutex_;
+    mutable std::shared_ptr<const DeviceSnapshot> snapshot_;
+    mutable std::atomic<uint64_t> snapshot_version_;
+
+    static uint64_t hash(uint64_t did);
+    Shard& shard_for(uint64_t hashed) const;
+    static Entry* find_entry(Shard& shard, uint64_t did, uint64_t hashed);
+    static void insert_slot(std::vector<Slot>& slots, uint64_t did, uint64_t hashed, uint32_t entry);
+    static void grow(Shard& shard);
+};
+
+} // namespace miot
+
+#endif // DEVICE_REGISTRY_H
@@ -0,0 +1,163 @@
+/**
+ * Frame Buffer - Refcounted, pooled frame payload storage
+ * 
+ * Frame payloads are copied once from the camera library into a pooled
+ * buffer and then shared by reference all the way into GStreamer.
+ * 
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace miot {
+
+class FrameBufferPool;
+
+/**
+ * @brief Fixed-capacity byte buffer handed out by FrameBufferPool
+ */
+class FrameBuffer {
+public:
+    uint8_t* data() { return storage_.get(); }
+    const uint8_t* data() const { return storage_.get(); }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    
+    /**
+     * @brief Copy payload into the buffer
+     * @param src Source bytes
+     * @param len Number of bytes (must not exceed capacity)
+     */
+    void assign(const uint8_t* src, size_t len);
+
+private:
+    friend class FrameBufferPool;
+    
+    explicit FrameBuffer(size_t capacity);
+    
+    std::unique_ptr<uint8_t[]> storage_;
+    size_t capacity_;
+    size_t size_;
+};
+
+/**
+ * @brief Shared handle to a pooled buffer
+ * 
+ * The buffer returns to its pool when the last reference is dropped.
+ */
+using FrameBufferPtr = std::shared_ptr<FrameBuffer>;
+
+/**
+ * @brief Frame buffer pool configuration
+ */
+struct FrameBufferPoolConfig {
+    // A cached GOP pins up to 256 frames / 8 MiB (GstRtspServer::GOP_CACHE_MAX_*) and is
+    // released in one go at the next IDR; the free lists must take it back whole, and the
+    // byte cap must hold it next to the frame queue and GStreamer's in-flight buffers
+    static constexpr size_t DEFAULT_MAX_TOTAL_BYTES = 32 * 1024 * 1024;
+    static constexpr size_t DEFAULT_MAX_FREE_PER_CLASS = 256;
+    
+    size_t max_total_bytes;     // Cap on bytes held by the pool (in use + idle)
+    size_t max_free_per_class;  // Idle buffers kept per size class
+    
+    FrameBufferPoolConfig()
+        : max_total_bytes(DEFAULT_MAX_TOTAL_BYTES), max_free_per_class(DEFAULT_MAX_FREE_PER_CLASS) {}
+};
+
+/**
+ * @brief Frame buffer pool statistics
+ */
+struct FrameBufferPoolStats {
+    uint64_t hits;              // Acquires served from an idle buffer
+    uint64_t misses;            // Acquires that allocated a new buffer
+    uint64_t oversize;          // Acquires larger than the biggest size class
+    uint64_t rejected;          // Acquires refused because of max_total_bytes
+    size_t bytes_in_use;        // Bytes referenced by live frames
+    size_t bytes_total;         // Bytes held by the pool (in use + idle)
+    size_t high_water_bytes;    // Peak of bytes_in_use
+    
+    FrameBufferPoolStats() : hits(0), misses(0), oversize(0), rejected(0),
+                             bytes_in_use(0), bytes_total(0), high_water_bytes(0) {}
+};
+
+/**
+ * @brief Size-class pool of reusable frame buffers
+ * 
+ * Payloads are served from three size classes: 4 KiB (audio), 64 KiB
+ * (P frames) and 512 KiB (I frames). Buffers released by consumers (e.g.
+ * GStreamer after payloading) go back to their class free list. Larger
+ * frames get an exact-size buffer that is freed on release.
+ * 
+ * The pool is always owned by a shared_ptr so outstanding buffers can
+ * outlive it safely. One pool is used per camera, so its high-water mark
+ * is that camera's peak payload memory.
+ */
+class FrameBufferPool : public std::enable_shared_from_this<FrameBufferPool> {
+public:
+    static constexpr size_t NUM_SIZE_CLASSES = 3;
+    static constexpr size_t SIZE_CLASSES[NUM_SIZE_CLASSES] = {
+        4 * 1024,       // Audio
+        64 * 1024,      // P frames
+        512 * 1024      // I frames
+    };
+    
+    /**
+     * @brief Create a pool
+     * @param config Pool limits
+     */
+    static std::shared_ptr<FrameBufferPool> create(const FrameBufferPoolConfig& config = FrameBufferPoolConfig());
+    
+    ~FrameBufferPool();
+    
+    // Disable copy
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+    
+    /**
+     * @brief Acquire a buffer able to hold at least size bytes
+     * @param size Required capacity
+     * @return Buffer with size() == 0, or nullptr if the byte cap is reached
+     */
+    FrameBufferPtr acquire(size_t size);
+    
+    /**
+     * @brief Acquire a buffer and fill it from src
+     * @return Filled buffer, or nullptr if the byte cap is reached
+     */
+    FrameBufferPtr copy_from(const uint8_t* src, size_t len);
+    
+    /**
+     * @brief Number of idle buffers currently held
+     */
+    size_t free_count() const;
+    
+    /**
+     * @brief Get pool statistics
+     */
+    FrameBufferPoolStats stats() const;
+
+private:
+    explicit FrameBufferPool(const FrameBufferPoolConfig& config);
+    
+    static size_t size_class_for(size_t size);
+    static void recycle(const std::weak_ptr<FrameBufferPool>& pool, FrameBuffer* buffer);
+    void release(FrameBuffer* buffer);
+    bool reserve_bytes(size_t bytes);
+    
+    FrameBufferPoolConfig config_;
+    std::vector<FrameBuffer*> free_[NUM_SIZE_CLASSES];
+    FrameBufferPoolStats stats_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace miot
+
+#endif // FRAME_BUFFER_H
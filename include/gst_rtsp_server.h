@@ -4,12 +4,19 @@
 #include <gst/gst.h>
 #include <gst/rtsp-server/rtsp-server.h>
 #include <string>
+#include <vector>
+#include <map>
 #include <mutex>
 #include <queue>
 #include <memory>
 #include <thread>
 #include <atomic>
 #include <condition_variable>
+#include <functional>
+#include <chrono>
+
+#include "frame_buffer.h"
+#include "miot_camera_client.h"
 
 namespace miot {
 
@@ -26,7 +33,11 @@ struct AudioFrame {
 
 class GstRtspServer {
 public:
-    GstRtspServer(int port = 8554, const std::string& mount_point = "/camera");
+    // 挂载点客户端状态变化：active=true 表示有客户端开始拉流，
+    // active=false 表示最后一个客户端离开并超过 idle linger（在 GMainLoop 线程调用）
+    using ClientPresenceCallback = std::function<void(const std::string& mount_point, bool active)>;
+    
+    GstRtspServer(int port = 8554);
     ~GstRtspServer();
 
     // 初始化 GStreamer
@@ -38,37 +49,150 @@ public:
     // 停止 RTSP 服务器
     void stop();
     
-    // 推送视频帧数据
-    void push_video_frame(const std::vector<uint8_t>& data, uint64_t timestamp, bool is_keyframe);
+    // 添加挂载点（每个摄像头一个，运行时可随时添加）
+    // pipeline 在收到第一帧、知道实际编码后才创建并对外提供
+    bool add_mount(const std::string& mount_point);
+    
+    // 移除挂载点，已连接的客户端会收到 EOS
+    void remove_mount(const std::string& mount_point);
+    
+    // 挂载点是否存在
+    bool has_mount(const std::string& mount_point) const;
+    
+    // 按需推流：注册客户端状态回调，最后一个客户端离开 idle_linger 后通知空闲
+    // 挂载点首次对外提供但一直无人连接时，同样在 idle_linger 后通知空闲
+    void set_client_presence_callback(ClientPresenceCallback callback, 
+                                      std::chrono::milliseconds idle_linger);
     
-    // 推送音频帧数据
-    void push_audio_frame(const std::vector<uint8_t>& data, uint64_t timestamp);
+    // 丢弃挂载点的 GOP 缓存（摄像头停止推流后调用，避免新客户端看到过期画面）
+    void reset_mount(const std::string& mount_point);
+    
+    // 推送视频帧数据（零拷贝，GstBuffer 持有 frame 引用直到释放）
+    void push_video_frame(const std::string& mount_point, CameraCodec codec, const FrameBufferPtr& frame, 
+                          uint64_t timestamp, bool is_keyframe);
+    
+    // 推送音频帧数据（零拷贝）
+    void push_audio_frame(const std::string& mount_point, CameraCodec codec, const FrameBufferPtr& frame, 
+                          uint64_t timestamp);
     
     // 获取 RTSP URL
-    std::string get_url() const;
+    std::string get_url(const std::string& mount_point = "") const;
+    
+    // 由摄像头名称生成合法的挂载点，例如 "Living Room" -> "/living_room"
+    static std::string make_mount_point(const std::string& name);
 
 private:
     int port_;
-    std::string mount_point_;
     
     GstRTSPServer* server_ = nullptr;
     GMainLoop* loop_ = nullptr;
     std::thread server_thread_;
     std::atomic<bool> running_{false};
     
+    // 按需推流（start() 之前设置）
+    ClientPresenceCallback presence_callback_;
+    std::chrono::milliseconds idle_linger_{0};
+    
     // 帧队列
     std::queue<VideoFrame> frame_queue_;
     std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
-
-    uint64_t video_base_timestamp_ = 0;  // 视频基准时间戳
-    uint64_t audio_base_timestamp_ = 0;  // 音频基准时间戳
-    bool first_video_frame_ = true;      // 是否是第一个视频帧
-    bool first_audio_frame_ = true;      // 是否是第一个音频帧
     
-    // appsrc 相关
-    GstElement* video_appsrc_ = nullptr;
-    GstElement* audio_appsrc_ = nullptr;
+    // GOP 缓存中的一帧
+    struct CachedVideoFrame {
+        FrameBufferPtr buffer;
+        uint64_t timestamp;
+        bool is_keyframe;
+    };
+    static constexpr size_t GOP_CACHE_MAX_FRAMES = 256;
+    static constexpr size_t GOP_CACHE_MAX_BYTES = 8 * 1024 * 1024;
+    
+    // 帧缓冲池默认配置要能整个收回一个 GOP，并在其之外留出同样多的在途帧空间
+    static_assert(FrameBufferPoolConfig::DEFAULT_MAX_FREE_PER_CLASS >= GOP_CACHE_MAX_FRAMES,
+                  "frame pool free lists smaller than the GOP cache");
+    static_assert(FrameBufferPoolConfig::DEFAULT_MAX_TOTAL_BYTES >= 2 * GOP_CACHE_MAX_BYTES,
+                  "frame pool byte cap cannot hold a cached GOP plus in-flight frames");
+    
+    // 编码对应的 parse/payload 元素，编译期由 CodecTraits 生成
+    struct CodecPipeline;
+    template <CameraCodec Codec>
+    static constexpr CodecPipeline make_codec_pipeline(const char* name);
+    static const CodecPipeline* find_codec_pipeline(CameraCodec codec);
+    
+    // 每个挂载点独立的 appsrc 和时间戳状态
+    struct Mount {
+        std::string path;
+        GstRtspServer* server = nullptr;
+        
+        // 保护以下状态（推流线程与 GMainLoop 线程共享）
+        std::mutex state_mutex;
+        bool removed = false;
+        
+        // 收到第一帧后才创建 factory
+        GstRTSPMediaFactory* factory = nullptr;
+        const CodecPipeline* video_pipeline = nullptr;
+        const CodecPipeline* audio_pipeline = nullptr;
+        CameraCodec video_codec = CameraCodec::VIDEO_H264;
+        CameraCodec audio_codec = CameraCodec::AUDIO_G711A;
+        bool has_video_codec = false;
+        bool has_audio_codec = false;
+        
+        // 最近一次拒绝的编码，同一编码只报一次
+        CameraCodec rejected_video_codec = CameraCodec::VIDEO_H264;
+        CameraCodec rejected_audio_codec = CameraCodec::AUDIO_G711A;
+        bool has_rejected_video_codec = false;
+        bool has_rejected_audio_codec = false;
+        
+        uint64_t video_base_timestamp = 0;  // 视频基准时间戳
+        uint64_t audio_base_timestamp = 0;  // 音频基准时间戳
+        bool first_video_frame = true;      // 是否是第一个视频帧
+        bool first_audio_frame = true;      // 是否是第一个音频帧
+        
+        // appsrc 相关（属于当前的共享 media）
+        GstRTSPMedia* media = nullptr;
+        GstElement* video_appsrc = nullptr;
+        GstElement* audio_appsrc = nullptr;
+        
+        // GOP 缓存：最近一个 GOP（参数集 + IDR + 后续 P 帧），新客户端连接时先回放
+        std::vector<CachedVideoFrame> gop_cache;
+        size_t gop_cache_bytes = 0;
+        bool gop_replay_pending = false;    // appsrc 开始取数据后回放 GOP
+        
+        // 空闲计时（默认 GMainContext 上的 timeout source，0 表示未计时）
+        guint idle_source = 0;
+    };
+    using MountPtr = std::shared_ptr<Mount>;
+    
+    std::map<std::string, MountPtr> mounts_;
+    mutable std::mutex mounts_mutex_;
+    
+    MountPtr find_mount(const std::string& mount_point) const;
+    
+    void on_video_codec(const MountPtr& mount, CameraCodec codec);
+    void on_audio_codec(const MountPtr& mount, CameraCodec codec);
+    void update_factory(const MountPtr& mount);
+    void restart_media(const MountPtr& mount);
+    static std::string build_launch(const Mount& mount);
+    
+    static void cache_video_frame(Mount& mount, const FrameBufferPtr& frame, uint64_t timestamp, bool is_keyframe);
+    static void replay_gop_cache(Mount& mount);
+    static void push_video_buffer(Mount& mount, const FrameBufferPtr& frame, uint64_t timestamp, bool is_keyframe, bool discont);
+    static void release_appsrcs(Mount& mount);
+    static void clear_gop_cache(Mount& mount);
+    
+    // 空闲计时，需持有 state_mutex
+    void schedule_idle(const MountPtr& mount);
+    static void cancel_idle(Mount& mount);
+    static gboolean idle_timeout_callback(gpointer user_data);
+    
+    // 将 FrameBuffer 包装为 GstBuffer
+    static GstBuffer* wrap_frame_buffer(const FrameBufferPtr& frame);
+    static void release_frame_buffer(gpointer user_data);
+    
+    // 信号回调持有 MountPtr 的拷贝，挂载点移除后仍然安全
+    static gpointer ref_mount(const MountPtr& mount);
+    static void unref_mount(gpointer data, GClosure* closure);
+    static void unref_mount_source(gpointer data);
     
     // 静态回调
     static void media_configure_callback(GstRTSPMediaFactory* factory, 
@@ -76,8 +200,9 @@ private:
                                          gpointer user_data);
     static void need_data_callback(GstElement* appsrc, guint unused, gpointer user_data);
     static void media_unprepared_callback(GstRTSPMedia* media, gpointer user_data);
+    static gboolean unprepare_media_callback(gpointer user_data);
 };
 
 } // namespace miot
 
-#endif // GST_RTSP_SERVER_H
\ No newline at end of file
+#endif // GST_RTSP_SERVER_H
@@ -0,0 +1,154 @@
+/**
+ * Asynchronous HTTP Engine
+ *
+ * A single event-loop thread driving libcurl's multi interface, so many
+ * requests can be in flight without blocking the threads that issue them.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef HTTP_ASYNC_ENGINE_H
+#define HTTP_ASYNC_ENGINE_H
+
+#include "http_client_pool.h"
+
+#include <curl/curl.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+namespace miot {
+
+/**
+ * @brief HTTP request description
+ */
+struct HttpRequest {
+    std::string url;
+    bool post = false;                          // POST with body, otherwise GET
+    std::string body;
+    std::map<std::string, std::string> headers;
+    bool follow_redirects = false;
+    std::chrono::milliseconds timeout{30000};   // Whole-transfer timeout
+};
+
+/**
+ * @brief HTTP response
+ */
+struct HttpResponse {
+    CURLcode result = CURLE_OK;   // Transport result
+    long status = 0;              // HTTP status code (0 if no response)
+    std::string body;
+
+    bool ok() const { return result == CURLE_OK && status >= 200 && status < 300; }
+};
+
+/**
+ * @brief Completion callback, runs on the engine thread (keep it short and
+ *        never wait on another request of the same engine from inside it)
+ */
+using HttpCallback = std::function<void(HttpResponse&)>;
+
+/**
+ * @brief curl_multi based request engine
+ *
+ * Requests beyond max_in_flight wait in a FIFO queue. HTTP/2 connections
+ * negotiated by the pool's handles are multiplexed when the server allows it.
+ */
+class HttpAsyncEngine {
+public:
+    /**
+     * @brief Constructor
+     * @param pool Handle pool (shared DNS and TLS session caches)
+     * @param max_in_flight Maximum concurrent transfers (default: 16)
+     */
+    explicit HttpAsyncEngine(std::shared_ptr<HttpClientPool> pool = HttpClientPool::shared(),
+                             size_t max_in_flight = 16);
+
+    /**
+     * @brief Destructor, stops the event loop
+     */
+    ~HttpAsyncEngine();
+
+    // Disable copy
+    HttpAsyncEngine(const HttpAsyncEngine&) = delete;
+    HttpAsyncEngine& operator=(const HttpAsyncEngine&) = delete;
+
+    /**
+     * @brief Start the event-loop thread
+     * @return true if running
+     */
+    bool start();
+
+    /**
+     * @brief Stop the event loop, failing queued and active requests with CURLE_ABORTED_BY_CALLBACK
+     */
+    void stop();
+
+    /**
+     * @brief Set the maximum number of concurrent transfers
+     */
+    void set_max_in_flight(size_t max_in_flight);
+
+    /**
+     * @brief Submit a request with a completion callback
+     */
+    void submit(HttpRequest request, HttpCallback callback);
+
+    /**
+     * @brief Submit a request and get a future for the response
+     */
+    std::future<HttpResponse> submit(HttpRequest request);
+
+    /**
+     * @brief Number of active transfers
+     */
+    size_t in_flight() const { return in_flight_; }
+
+    /**
+     * @brief Number of requests waiting for a transfer slot
+     */
+    size_t queued() const;
+
+private:
+    struct Transfer {
+        HttpRequest request;
+        HttpCallback callback;
+        HttpClientPool::Handle handle;
+        curl_slist* headers = nullptr;
+        HttpResponse response;
+    };
+
+    std::shared_ptr<HttpClientPool> pool_;
+    CURLM* multi_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<size_t> max_in_flight_;
+    std::atomic<size_t> in_flight_;
+
+    // Submitted, not yet started (guarded by mutex_)
+    std::deque<std::unique_ptr<Transfer>> pending_;
+    mutable std::mutex mutex_;
+
+    // Started transfers, only touched by the event-loop thread
+    std::map<CURL*, std::unique_ptr<Transfer>> active_;
+
+    void event_loop();
+    void start_pending();
+    bool start_transfer(std::unique_ptr<Transfer> transfer);
+    void finish_transfer(CURL* curl, CURLcode result);
+    static void complete(Transfer& transfer);
+};
+
+} // namespace miot
+
+#endif // HTTP_ASYNC_ENGINE_H
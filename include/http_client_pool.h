@@ -0,0 +1,82 @@
+/**
+ * HTTP Client Pool
+ *
+ * Long-lived libcurl easy handles sharing one CURLSH (DNS cache and TLS
+ * sessions). Each handle keeps its own keep-alive connections between uses,
+ * so repeated requests to the same host skip the TCP and TLS handshakes.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef HTTP_CLIENT_POOL_H
+#define HTTP_CLIENT_POOL_H
+
+#include <curl/curl.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace miot {
+
+/**
+ * @brief Pool of reusable curl easy handles
+ *
+ * Handles returned by acquire() are reset to defaults with the shared state,
+ * keep-alive and HTTP/2 (negotiated over TLS) already configured. They go
+ * back to the pool when the Handle is destroyed, even after the pool itself
+ * has been released.
+ */
+class HttpClientPool : public std::enable_shared_from_this<HttpClientPool> {
+public:
+    // CURLSH and its locks; every handle keeps it alive until the handle is cleaned up
+    struct Share;
+
+    struct HandleReleaser {
+        std::weak_ptr<HttpClientPool> pool;
+        std::shared_ptr<Share> share;
+        void operator()(CURL* curl) const;
+    };
+    using Handle = std::unique_ptr<CURL, HandleReleaser>;
+
+    /**
+     * @brief Create a pool
+     * @param max_idle Idle handles kept for reuse (default: 8)
+     */
+    static std::shared_ptr<HttpClientPool> create(size_t max_idle = 8);
+
+    /**
+     * @brief Process-wide pool, shared by every client talking to the MIoT API
+     *
+     * Lives as long as at least one caller holds it.
+     */
+    static std::shared_ptr<HttpClientPool> shared();
+
+    ~HttpClientPool();
+
+    // Disable copy
+    HttpClientPool(const HttpClientPool&) = delete;
+    HttpClientPool& operator=(const HttpClientPool&) = delete;
+
+    /**
+     * @brief Take a handle from the pool (or create one)
+     * @return Handle, empty if curl could not create one
+     */
+    Handle acquire();
+
+private:
+    explicit HttpClientPool(size_t max_idle);
+
+    void release(CURL* curl);
+
+    std::shared_ptr<Share> share_;
+
+    std::vector<CURL*> idle_;
+    std::mutex idle_mutex_;
+    size_t max_idle_;
+};
+
+} // namespace miot
+
+#endif // HTTP_CLIENT_POOL_H
@@ -16,9 +16,18 @@
 #include <memory>
 #include <functional>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <array>
+#include <utility>
 #include <cstdint>
 #include <cstring>
 
+#include "frame_buffer.h"
+#include "spsc_ring.h"
+
 namespace miot {
 
 // Forward declarations
@@ -66,6 +75,9 @@ enum class CameraStatus {
 
 /**
  * @brief Raw frame data structure
+ * 
+ * The payload lives in a pooled, refcounted FrameBuffer; holding a copy of
+ * the buffer pointer keeps the payload alive without copying it.
  */
 struct RawFrameData {
     CameraCodec codec_id;
@@ -74,10 +86,45 @@ struct RawFrameData {
     uint32_t sequence;
     FrameType frame_type;
     uint8_t channel;
-    std::vector<uint8_t> data;
+    FrameBufferPtr buffer;
     
     RawFrameData() : codec_id(CameraCodec::VIDEO_H264), length(0), timestamp(0), 
                      sequence(0), frame_type(FrameType::P_FRAME), channel(0) {}
+    
+    const uint8_t* data() const { return buffer ? buffer->data() : nullptr; }
+    size_t size() const { return buffer ? buffer->size() : 0; }
+};
+
+/**
+ * @brief What to do when a camera's frame queue is full
+ */
+enum class OverflowPolicy {
+    DROP_NEWEST = 1,        // Drop only the frame that did not fit
+    DROP_UNTIL_KEYFRAME = 2 // Drop video until the next I frame so the decoder never sees a broken GOP
+};
+
+/**
+ * @brief Frame queue configuration (applies to cameras created afterwards)
+ */
+struct FrameQueueConfig {
+    size_t capacity;        // Frames per camera (rounded up to a power of two)
+    OverflowPolicy policy;
+    
+    FrameQueueConfig() : capacity(64), policy(OverflowPolicy::DROP_UNTIL_KEYFRAME) {}
+};
+
+/**
+ * @brief Per-camera frame queue statistics
+ */
+struct FrameQueueStats {
+    uint64_t enqueued;      // Frames accepted from the library thread
+    uint64_t dispatched;    // Frames delivered to callbacks
+    uint64_t dropped;       // Frames discarded by the overflow policy
+    uint64_t overflows;     // Times the queue was found full
+    size_t depth;           // Frames currently queued
+    size_t capacity;        // Queue capacity
+    
+    FrameQueueStats() : enqueued(0), dispatched(0), dropped(0), overflows(0), depth(0), capacity(0) {}
 };
 
 /**
@@ -115,6 +162,16 @@ public:
     MIoTCameraClient(const MIoTCameraClient&) = delete;
     MIoTCameraClient& operator=(const MIoTCameraClient&) = delete;
     
+    /**
+     * @brief Load the camera library and bind its functions
+     *
+     * Needs no access token, so it can run while the token is still being
+     * obtained. Called by init() if not done yet.
+     *
+     * @return true if loaded successfully
+     */
+    bool load();
+    
     /**
      * @brief Initialize the client
      * @return true if initialized successfully
@@ -193,6 +250,42 @@ public:
      * @return Version string
      */
     std::string get_version();
+    
+    /**
+     * @brief Hand a refreshed access token to the camera library
+     *
+     * Running sessions are kept; the library uses the new token from now on.
+     *
+     * @param access_token New OAuth2 access token
+     * @return true if the library accepted it
+     */
+    bool update_access_token(const std::string& access_token);
+    
+    /**
+     * @brief Set frame queue configuration for cameras created afterwards
+     * @param config Queue capacity and overflow policy
+     */
+    void set_frame_queue_config(const FrameQueueConfig& config);
+    
+    /**
+     * @brief Get frame queue statistics
+     * @param did Device ID
+     * @return Statistics (all zero if camera not found)
+     */
+    FrameQueueStats get_frame_queue_stats(const std::string& did);
+    
+    /**
+     * @brief Set payload pool configuration for cameras created afterwards
+     * @param config Byte cap and idle buffer limits (per camera)
+     */
+    void set_frame_pool_config(const FrameBufferPoolConfig& config);
+    
+    /**
+     * @brief Get payload pool statistics
+     * @param did Device ID
+     * @return Hit/miss counters and high-water mark (all zero if camera not found)
+     */
+    FrameBufferPoolStats get_frame_pool_stats(const std::string& did);
 
 private:
     // Library handle
@@ -200,7 +293,9 @@ private:
     
     // Configuration
     std::string cloud_server_;
-    std::string access_token_;
+    std::string access_token_;      // Guarded by token_mutex_
+    bool library_initialized_;      // Guarded by token_mutex_
+    std::mutex token_mutex_;
     std::string lib_path_;
     std::string host_;
     
@@ -210,13 +305,49 @@ private:
         std::string did;
         std::string model;
         int channel_count;
+        size_t slot;
+        
+        // User callbacks, invoked on the dispatch worker
+        std::mutex callbacks_mutex;
         std::map<int, RawVideoCallback> video_callbacks;
         std::map<int, RawAudioCallback> audio_callbacks;
         StatusChangeCallback status_callback;
+        
+        // Library thread -> dispatch worker hand-off
+        std::shared_ptr<FrameBufferPool> frame_pool;
+        std::unique_ptr<SpscRing<RawFrameData>> frame_ring;
+        OverflowPolicy overflow_policy;
+        bool waiting_keyframe;  // Producer side only
+        std::deque<int> pending_status;  // Guarded by wake_mutex
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+        std::atomic<bool> consumer_waiting{false};
+        std::atomic<bool> dispatch_running{false};
+        std::thread dispatch_thread;
+        
+        // Statistics
+        std::atomic<uint64_t> frames_enqueued{0};
+        std::atomic<uint64_t> frames_dispatched{0};
+        std::atomic<uint64_t> frames_dropped{0};
+        std::atomic<uint64_t> queue_overflows{0};
     };
     
-    std::map<std::string, CameraInstance> cameras_;
+    std::map<std::string, std::unique_ptr<CameraInstance>> cameras_;
     mutable std::mutex cameras_mutex_;
+    FrameQueueConfig queue_config_;
+    FrameBufferPoolConfig pool_config_;
+    
+    // Callback routing slots
+    // The library callbacks carry no context pointer, so every camera owns one
+    // slot with its own trampoline pair; a slot maps back to exactly one camera.
+    // The library thread reads a slot without taking cameras_mutex_; `active`
+    // lets release_slot() wait until no callback is still using the camera.
+    struct CallbackSlot {
+        std::atomic<CameraInstance*> camera{nullptr};
+        std::atomic<int> active{0};
+    };
+    static constexpr size_t MAX_CAMERA_SLOTS = 32;
+    std::array<CallbackSlot, MAX_CAMERA_SLOTS> slots_;
     
     // Callback storage (to keep function pointers alive)
     std::map<std::string, void*> callback_refs_;
@@ -252,17 +383,36 @@ private:
     bool bind_functions();
     std::string find_library_path();
     
+    bool acquire_slot(CameraInstance& camera);
+    void release_slot(CameraInstance& camera);
+    void start_dispatch(CameraInstance& camera);
+    void stop_dispatch(CameraInstance& camera);
+    void dispatch_loop(CameraInstance& camera);
+    void wake_dispatch(CameraInstance& camera);
+    
     // Static callbacks (bridge to member functions)
+    using RawDataTrampoline = void(*)(const void*, const uint8_t*);
+    using StatusTrampoline = void(*)(int);
+    
     static void log_callback(int level, const char* msg);
-    static void raw_data_callback(const void* frame_header, const uint8_t* data);
-    static void status_callback(int status);
+    template <size_t Slot>
+    static void raw_data_trampoline(const void* frame_header, const uint8_t* data);
+    template <size_t Slot>
+    static void status_trampoline(int status);
+    template <size_t... Slots>
+    static RawDataTrampoline raw_data_trampoline_at(size_t slot, std::index_sequence<Slots...>);
+    template <size_t... Slots>
+    static StatusTrampoline status_trampoline_at(size_t slot, std::index_sequence<Slots...>);
     
     // Singleton instance for static callbacks
     static MIoTCameraClient* instance_;
     
     // Internal callback handlers
-    void handle_raw_data(const std::string& did, const void* frame_header, const uint8_t* data);
-    void handle_status_change(const std::string& did, int status);
+    void dispatch_raw_data(size_t slot, const void* frame_header, const uint8_t* data);
+    void dispatch_status_change(size_t slot, int status);
+    void enqueue_raw_data(CameraInstance& camera, const void* frame_header, const uint8_t* data);
+    void handle_raw_data(CameraInstance& camera, const RawFrameData& frame);
+    void handle_status_change(CameraInstance& camera, int status);
 };
 
 } // namespace miot
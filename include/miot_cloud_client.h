@@ -15,6 +15,15 @@
 #include <map>
 #include <memory>
 #include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+
+#include "http_async_engine.h"
+#include "cloud_crypto.h"
 
 namespace miot {
 
@@ -113,15 +122,66 @@ public:
      */
     std::map<std::string, CloudDeviceInfo> get_devices(const std::vector<std::string>& dids);
     
+    /**
+     * @brief Get device information by DID list without blocking
+     * @param dids List of device IDs
+     * @param callback Receives the map of DID to device info (empty on failure);
+     *                 runs on the HTTP engine thread
+     */
+    void get_devices_async(const std::vector<std::string>& dids,
+                           std::function<void(std::map<std::string, CloudDeviceInfo>)> callback);
+    
+    /**
+     * @brief Get device information by DID list as a future
+     * @param dids List of device IDs
+     * @return Future resolved with the map of DID to device info
+     */
+    std::future<std::map<std::string, CloudDeviceInfo>> get_devices_async(const std::vector<std::string>& dids);
+    
     /**
      * @brief Get device information by single DID
+     * 
+     * Goes through the batched lookup, so concurrent callers share one request.
+     * 
      * @param did Device ID
      * @return Device info (empty if not found)
      */
     CloudDeviceInfo get_device(const std::string& did);
     
+    /**
+     * @brief Queue a device lookup
+     * 
+     * Lookups are coalesced for up to the batch window (or until max_batch DIDs
+     * are queued) and sent as a single get_devices request.
+     * 
+     * @param did Device ID
+     * @return Future resolved with the device info (empty if not found or failed)
+     */
+    std::shared_future<CloudDeviceInfo> get_device_async(const std::string& did);
+    
+    /**
+     * @brief Set lookup batching parameters
+     * @param window How long to collect DIDs after the first one (default: 50ms)
+     * @param max_batch Send immediately once this many DIDs are queued (default: 200)
+     */
+    void set_lookup_batching(std::chrono::milliseconds window, size_t max_batch);
+    
+    /**
+     * @brief Set the maximum number of concurrent HTTP requests (default: 16)
+     */
+    void set_max_in_flight(size_t max_in_flight);
+    
+    /**
+     * @brief Set the per-request timeout (default: 30s)
+     */
+    void set_request_timeout(std::chrono::milliseconds timeout);
+    
     /**
      * @brief Update access token
+     *
+     * Safe to call while requests are running; requests built afterwards
+     * carry the new token.
+     *
      * @param access_token New access token
      */
     void set_access_token(const std::string& access_token);
@@ -134,35 +194,48 @@ public:
 
 private:
     // Configuration
-    std::string access_token_;
+    std::string access_token_;      // Guarded by token_mutex_
+    mutable std::mutex token_mutex_;
     std::string cloud_server_;
     std::string host_;
     std::string base_url_;
     
-    // Encryption keys
-    std::vector<uint8_t> aes_key_;
+    // Requests run on one curl_multi event loop over keep-alive connections
+    std::unique_ptr<HttpAsyncEngine> http_engine_;
+    std::atomic<long long> request_timeout_ms_;
+    
+    // Session key and reusable cipher contexts
+    CloudCrypto crypto_;
     std::string client_secret_b64_;
     
+    // Batched device lookups
+    struct PendingLookup {
+        std::promise<CloudDeviceInfo> promise;
+        std::shared_future<CloudDeviceInfo> future;
+    };
+    std::map<std::string, PendingLookup> pending_lookups_;
+    std::chrono::steady_clock::time_point lookup_deadline_;
+    std::chrono::milliseconds lookup_window_;
+    size_t lookup_max_batch_;
+    bool lookup_stopping_;
+    std::thread lookup_thread_;
+    std::mutex lookup_mutex_;
+    std::condition_variable lookup_cv_;
+    
     // Private methods
-    bool generate_aes_key();
     bool generate_client_secret();
     std::string aes_encrypt_with_b64(const std::string& json_data);
     std::string aes_decrypt_with_b64(const std::string& encrypted_b64);
-    std::string http_post(const std::string& url_path, const std::string& encrypted_data);
+    HttpRequest build_api_request(const std::string& url_path, const std::string& encrypted_data);
+    std::map<std::string, CloudDeviceInfo> parse_device_list(const HttpResponse& response);
     std::map<std::string, std::string> get_api_headers();
-    
-    // Helper methods
-    std::string base64_encode(const uint8_t* data, size_t len);
-    std::vector<uint8_t> base64_decode(const std::string& encoded);
-    std::vector<uint8_t> rsa_encrypt(const uint8_t* data, size_t len);
-    std::vector<uint8_t> aes_cbc_encrypt(const std::vector<uint8_t>& plaintext);
-    std::vector<uint8_t> aes_cbc_decrypt(const std::vector<uint8_t>& ciphertext);
-    std::vector<uint8_t> pkcs7_pad(const std::vector<uint8_t>& data, size_t block_size);
-    std::vector<uint8_t> pkcs7_unpad(const std::vector<uint8_t>& data);
+    void lookup_loop();
 };
 
 /**
- * @brief Simple JSON parser/builder for API communication
+ * @brief JSON builder/parser for API communication
+ * 
+ * Responses are read by a hand-written single-pass scanner straight into CloudDeviceInfo.
  */
 class SimpleJson {
 public:
@@ -171,9 +244,6 @@ public:
     
 private:
     static std::string escape_json_string(const std::string& str);
-    static std::string extract_string(const std::string& json, const std::string& key);
-    static int extract_int(const std::string& json, const std::string& key);
-    static bool extract_bool(const std::string& json, const std::string& key);
 };
 
 } // namespace miot
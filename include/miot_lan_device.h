@@ -14,6 +14,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <memory>
 #include <functional>
 #include <thread>
@@ -21,6 +23,8 @@
 #include <atomic>
 #include <chrono>
 
+#include "device_event_dispatcher.h"
+
 namespace miot {
 
 enum class DeviceStatusChangedType {
@@ -46,6 +50,14 @@ struct DeviceInfo {
     DeviceInfo() : online(false), timestamp_offset(0) {}
 };
 
+/**
+ * @brief Immutable view of all devices at one point in time
+ */
+using DeviceSnapshot = std::vector<DeviceInfo>;
+
+class DeviceRegistry;
+class TimerWheel;
+
 /**
  * @brief Device status change callback
  * Parameters: did, device_info
@@ -68,7 +80,12 @@ class MIoTLanDiscovery {
 public:
     /**
      * @brief Constructor
-     * @param interfaces Network interface names to scan (e.g., "en0", "eth0")
+     * 
+     * On Linux the socket set follows link and address changes: with no
+     * interfaces given, every non-loopback interface with an IPv4 address
+     * is used as it comes and goes; given names are used while they exist.
+     * 
+     * @param interfaces Network interface names to scan (e.g., "en0", "eth0"; empty = all)
      * @param virtual_did Virtual device ID (0 = auto-generate random ID)
      */
     explicit MIoTLanDiscovery(const std::vector<std::string>& interfaces = {}, uint64_t virtual_did = 0);
@@ -106,16 +123,34 @@ public:
      */
     void ping(const std::string& interface_name = "", const std::string& target_ip = "");
     
+    /**
+     * @brief Check if a socket is open on an interface
+     * @param interface_name Network interface
+     * @return true if probes can be sent through it
+     */
+    bool has_interface(const std::string& interface_name) const;
+    
     /**
      * @brief Get all discovered devices
-     * @return Map of device ID to device info
+     * @return Map of device ID to a current copy of its info (last_seen is up to date)
      */
     std::map<std::string, DeviceInfo> get_devices() const;
     
+    /**
+     * @brief Get a shared, immutable snapshot of all devices without copying
+     * @return Snapshot as of the last status change (last_seen may lag)
+     */
+    std::shared_ptr<const DeviceSnapshot> get_device_snapshot() const;
+    
+    /**
+     * @brief Get the number of discovered devices
+     */
+    size_t get_device_count() const;
+    
     /**
      * @brief Get device by DID
      * @param did Device ID
-     * @return Device info (nullptr if not found)
+     * @return Copy of the device info (nullptr if not found)
      */
     std::shared_ptr<DeviceInfo> get_device(const std::string& did) const;
     
@@ -132,6 +167,12 @@ public:
      */
     void unregister_callback(const std::string& key);
     
+    /**
+     * @brief Get device event dispatcher metrics (queue depth, handler latency)
+     * @return Metrics snapshot
+     */
+    DeviceEventStats get_event_stats() const;
+    
     /**
      * @brief Set scan intervals
      * @param min_interval Minimum interval in seconds (default: 5s)
@@ -139,11 +180,46 @@ public:
      */
     void set_scan_intervals(double min_interval, double max_interval);
     
+    /**
+     * @brief Set unicast keepalive probe intervals for known devices
+     * @param interval Interval while a device answers (default: 30s)
+     * @param min_interval Floor the interval halves towards on each missed reply (default: 2s)
+     */
+    void set_keepalive_intervals(double interval, double min_interval);
+    
+    /**
+     * @brief Report a local network change (link up, address change)
+     * 
+     * Broadcasts a probe right away and restarts the broadcast backoff
+     * from the minimum scan interval.
+     */
+    void notify_network_changed();
+    
+    /**
+     * @brief Set the number of threads running status callbacks (call before start)
+     * @param count Worker threads (default: 4); callbacks for one device stay ordered
+     */
+    void set_event_workers(size_t count);
+    
     /**
      * @brief Set device timeout
-     * @param timeout Timeout in seconds (default: 100s)
+     * @param timeout Timeout in seconds (default: 100s), used for devices without a class timeout
      */
     void set_device_timeout(double timeout);
+    
+    /**
+     * @brief Set the offline timeout for a class of devices
+     * @param device_class Class name (e.g. "camera")
+     * @param timeout Timeout in seconds
+     */
+    void set_class_timeout(const std::string& device_class, double timeout);
+    
+    /**
+     * @brief Assign a device to a class; takes effect immediately if it is already online
+     * @param did Device ID
+     * @param device_class Class name set with set_class_timeout
+     */
+    void set_device_class(const std::string& did, const std::string& device_class);
 
 private:
     // OTU Protocol Constants
@@ -151,14 +227,22 @@ private:
     static constexpr size_t OT_PROBE_LEN = 32;
     static constexpr size_t OT_MSG_LEN = 1400;
     static constexpr uint8_t OT_HEADER[2] = {0x21, 0x31};  // "!1"
+    static constexpr size_t RECV_BATCH = 16;  // Datagrams per recvmmsg call
+    static constexpr double FAST_PROBE_WINDOW = 300.0;  // Seconds a silent device keeps the tight schedule
     
     struct SocketInfo {
         int fd;
         std::string interface;
     };
     
+    struct ProbeState {
+        int missed = 0;                                 // Keepalives in a row without a reply
+        std::chrono::steady_clock::time_point sent_at;  // Last keepalive sent
+    };
+    
     // Configuration
     std::vector<std::string> interfaces_;
+    bool auto_interfaces_;  // No interfaces given: follow whatever is up
     uint64_t virtual_did_;
     std::vector<uint8_t> probe_msg_;
     
@@ -167,35 +251,73 @@ private:
     std::thread discovery_thread_;
     std::thread timeout_checker_thread_;
     
+    // Event loop (Linux): epoll over all sockets, timerfd for probes, eventfd for stop,
+    // timerfd for the next per-device deadline (offline timeout or keepalive probe),
+    // rtnetlink for link and address changes
+    int epoll_fd_;
+    int timer_fd_;
+    int wake_fd_;
+    int device_timer_fd_;
+    int netlink_fd_;
+    struct RecvBatch;
+    
     // Sockets
     std::map<std::string, SocketInfo> sockets_;
     mutable std::mutex sockets_mutex_;
     
-    // Devices
-    std::map<std::string, std::shared_ptr<DeviceInfo>> devices_;
-    mutable std::mutex devices_mutex_;
+    // Devices, keyed by the numeric DID
+    std::unique_ptr<DeviceRegistry> devices_;
+    
+    // Offline deadlines; heartbeats only refresh last_seen, an expiring
+    // timer re-checks the device and is pushed back if it was seen since
+    std::unique_ptr<TimerWheel> liveness_wheel_;
+    std::unordered_map<uint64_t, std::string> device_classes_;
+    std::map<std::string, double> class_timeouts_;
+    
+    // Unicast keepalives to the last known address of each device
+    std::unique_ptr<TimerWheel> probe_wheel_;
+    std::unordered_map<uint64_t, ProbeState> probe_states_;
+    std::mutex device_timers_mutex_;
     
     // Callbacks
     std::map<std::string, DeviceStatusCallback> callbacks_;
     mutable std::mutex callbacks_mutex_;
     
+    // Callbacks run here, never on the discovery or timeout threads
+    DeviceEventDispatcher event_dispatcher_;
+    
     // Scan configuration
     double min_scan_interval_;
     double max_scan_interval_;
     double current_scan_interval_;
+    std::atomic<bool> scan_reset_pending_;
+    double keepalive_interval_;
+    double min_keepalive_interval_;
     double device_timeout_;
     
     // Private methods
     void init_probe_message();
     bool create_socket(const std::string& interface_name);
     void close_all_sockets();
+    std::set<std::string> find_interfaces() const;
+    bool open_netlink();
+    bool drain_netlink();
+    void sync_interfaces();
     void discovery_loop();
+    bool init_event_loop();
+    void close_event_loop();
+    void arm_probe_timer(double seconds);
+    void arm_device_timer();
+    std::chrono::steady_clock::duration device_timeout_for(uint64_t did) const;
+    void drain_socket(const SocketInfo& socket_info, RecvBatch& batch);
     void timeout_checker_loop();
     void send_probe(const std::string& interface_name = "", const std::string& target_ip = "");
-    void handle_received_data(const uint8_t* data, size_t len, const std::string& from_ip, const std::string& interface_name);
-    void update_device(const std::string& did, const std::string& ip, const std::string& interface_name, int64_t timestamp_offset);
+    void handle_received_data(const uint8_t* data, size_t len, uint32_t from_addr, const std::string& interface_name);
+    void update_device(uint64_t did, uint32_t ip_addr, const std::string& interface_name, int64_t timestamp_offset);
     void check_device_timeouts();
+    void send_keepalive_probes();
     void notify_callbacks(const std::string& did, const DeviceInfo& info);
+    void run_callbacks(const std::string& did, const DeviceInfo& info);
     double get_next_scan_interval();
     std::string get_local_ip(const std::string& interface_name);
 };
@@ -6,6 +6,13 @@
 #include <chrono>
 #include <thread>
 #include <atomic>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include "http_client_pool.h"
 
 namespace miot {
 
@@ -18,6 +25,10 @@ struct TokenInfo {
         return std::chrono::system_clock::now() >= expires_at;
     }
     
+    bool is_valid() const {
+        return !access_token.empty() && !is_expired();
+    }
+    
     bool needs_refresh() const {
         // 提前10分钟刷新
         auto now = std::chrono::system_clock::now();
@@ -26,6 +37,46 @@ struct TokenInfo {
     }
 };
 
+// 线程安全的token容器：每次更新版本号加一，并立即唤醒所有等待者
+class TokenHolder {
+public:
+    TokenHolder();
+    
+    // 更新token，返回新的版本号
+    uint64_t set(const TokenInfo& token);
+    
+    // 读取当前token（version为0表示还没有token）
+    TokenInfo get(uint64_t* version = nullptr) const;
+    
+    // 当前版本号
+    uint64_t version() const;
+    
+    // 等待有效token，直到deadline；已关闭且没有有效token时立即返回false
+    bool wait_valid(TokenInfo& token,
+                    std::chrono::steady_clock::time_point deadline,
+                    uint64_t* version = nullptr) const;
+    
+    // 等待比known_version更新的token，直到deadline；已关闭时立即返回false
+    bool wait_newer(uint64_t known_version,
+                    TokenInfo& token,
+                    std::chrono::steady_clock::time_point deadline,
+                    uint64_t* version = nullptr) const;
+    
+    // 开始/停止提供token（停止后等待者不再空等到超时）
+    void open();
+    void close();
+    
+private:
+    TokenInfo token_;
+    uint64_t version_;
+    bool closed_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cv_;
+};
+
+// token更新回调（在获取/刷新token的线程上调用）
+using TokenCallback = std::function<void(const TokenInfo& token)>;
+
 class MiotOAuth {
 public:
     MiotOAuth(const std::string& client_id, 
@@ -52,9 +103,16 @@ public:
     // 刷新token
     bool refresh_token();
     
-    // 获取当前token
+    // 获取当前token（没有有效token时等待，token一到立即返回）
     bool get_token(TokenInfo& token, std::chrono::seconds timeout = std::chrono::seconds(120));
     
+    // 当前token版本号（每次获取/刷新加一，0表示还没有token）
+    uint64_t token_version() const;
+    
+    // 等待比known_version更新的token
+    bool wait_token_update(uint64_t known_version, TokenInfo& token,
+                           std::chrono::milliseconds timeout, uint64_t* version = nullptr);
+    
     // 保存token到文件
     bool save_token(const std::string& filename = "miot_token.json") const;
 
@@ -64,6 +122,12 @@ public:
     // 检查token有效性
     bool is_token_valid() const;
     
+    // 订阅token更新：之后每次获取/刷新到新token都会回调，返回订阅ID
+    uint64_t subscribe_token(TokenCallback callback);
+    
+    // 取消订阅
+    void unsubscribe_token(uint64_t subscription_id);
+    
 private:
     std::string client_id_;
     std::string redirect_uri_;
@@ -72,9 +136,10 @@ private:
     std::string state_;
     std::string device_id_;
     std::string token_file_;
-    TokenInfo token_;
+    TokenHolder token_;
     
-    // HTTP请求
+    // HTTP请求（复用连接池中的长连接）
+    std::shared_ptr<HttpClientPool> http_pool_;
     std::string http_get(const std::string& url) const;
     std::string http_post(const std::string& url, const std::string& data) const;
     
@@ -86,6 +151,13 @@ private:
 
     void token_refresh_loop();
 
+    // 通知订阅者，并记录从拿到新token到全部送达的耗时
+    void notify_token_subscribers(std::chrono::steady_clock::time_point obtained_at);
+
+    std::map<uint64_t, TokenCallback> token_subscribers_;
+    uint64_t next_subscription_id_;
+    std::mutex subscribers_mutex_;
+
     std::atomic<bool> should_exit_;
     std::thread token_refresh_thread_;
 };
@@ -0,0 +1,128 @@
+/**
+ * SPSC Ring - Bounded lock-free single-producer/single-consumer queue
+ * 
+ * Used to hand frames from the camera library thread to a per-camera
+ * dispatch worker without taking any lock on the producer side.
+ * 
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace miot {
+
+/**
+ * @brief Bounded single-producer/single-consumer ring buffer
+ * 
+ * Capacity is rounded up to a power of two. try_push() must only be called
+ * from one thread and try_pop() from one (other) thread.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1),
+          slots_(mask_ + 1)
+    {
+    }
+    
+    // Disable copy
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    
+    /**
+     * @brief Enqueue an item (producer side)
+     * @return false if the ring is full; item is left untouched
+     */
+    bool try_push(T&& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Whether try_push() would fail right now (producer side)
+     * 
+     * Only the producer adds items, so a false result holds until its next push.
+     */
+    bool full() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            return tail - head_cache_ > mask_;
+        }
+        return false;
+    }
+    
+    /**
+     * @brief Dequeue an item (consumer side)
+     * @return false if the ring is empty
+     */
+    bool try_pop(T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        item = std::move(slots_[head & mask_]);
+        // Drop whatever the moved-from slot still references
+        slots_[head & mask_] = T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Approximate number of queued items (safe from any thread)
+     */
+    size_t size() const {
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+    
+    bool empty() const { return size() == 0; }
+    
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+    
+    static constexpr size_t CACHE_LINE = 64;
+    
+    const size_t mask_;
+    std::vector<T> slots_;
+    
+    // Consumer-owned index and its cached view of the producer index
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
+    
+    // Producer-owned index and its cached view of the consumer index
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
+};
+
+} // namespace miot
+
+#endif // SPSC_RING_H
@@ -0,0 +1,96 @@
+/**
+ * Startup Orchestrator
+ *
+ * Runs named startup stages concurrently, each one as soon as the stages it
+ * depends on have finished, and logs when every stage started and how long
+ * it took.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef STARTUP_ORCHESTRATOR_H
+#define STARTUP_ORCHESTRATOR_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <chrono>
+
+namespace miot {
+
+/**
+ * @brief Outcome of one startup stage
+ */
+struct StartupStageTiming {
+    std::string name;
+    bool succeeded = false;
+    bool skipped = false;                   // A dependency failed, stage never ran
+    std::chrono::milliseconds started_at{0};  // Offset from the start of run()
+    std::chrono::milliseconds duration{0};
+};
+
+/**
+ * @brief Dependency-ordered concurrent startup
+ *
+ * Every stage runs on its own thread. A stage whose dependency failed is
+ * skipped and counts as failed, so its own dependents are skipped too.
+ */
+class StartupOrchestrator {
+public:
+    using Stage = std::function<bool()>;
+
+    /**
+     * @brief Add a stage
+     * @param name Unique stage name
+     * @param depends_on Stages that must succeed first (must already be added)
+     * @param stage Work to run, returns true on success
+     * @return false if the name is taken or a dependency is unknown
+     */
+    bool add_stage(const std::string& name, const std::vector<std::string>& depends_on, Stage stage);
+
+    /**
+     * @brief Run all stages and wait for them
+     *
+     * Logs "[Startup] <stage> done in N ms (started at +M ms)" as each stage
+     * finishes and "[Startup] All stages done in N ms" at the end; these lines
+     * are the only startup timings the bridge measures.
+     *
+     * @return true if every stage succeeded
+     */
+    bool run();
+
+    /**
+     * @brief Whether a stage ran and succeeded (valid after run())
+     */
+    bool succeeded(const std::string& name) const;
+
+    /**
+     * @brief Per-stage timings in the order the stages were added (valid after run())
+     */
+    std::vector<StartupStageTiming> get_timings() const;
+
+private:
+    struct StageEntry {
+        std::string name;
+        std::vector<size_t> depends_on;
+        Stage stage;
+        std::promise<bool> done;
+        std::shared_future<bool> result;
+        StartupStageTiming timing;
+    };
+
+    std::vector<std::unique_ptr<StageEntry>> stages_;
+    std::map<std::string, size_t> index_;
+    mutable std::mutex mutex_;
+
+    void run_stage(StageEntry& entry, std::chrono::steady_clock::time_point origin);
+};
+
+} // namespace miot
+
+#endif // STARTUP_ORCHESTRATOR_H
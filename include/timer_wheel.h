@@ -0,0 +1,101 @@
+/**
+ * Timer Wheel
+ *
+ * Hierarchical timing wheel for large numbers of keyed deadlines (device
+ * liveness): scheduling, rescheduling and cancelling are O(1), and expiry
+ * only touches the slots whose time has come.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+
+namespace miot {
+
+/**
+ * @brief Three-level timing wheel keyed by a 64-bit ID
+ *
+ * Each level has 256 slots; a level-n slot spans 256^n ticks, so with a
+ * 100 ms tick the wheel covers about 19 days before clamping. A key has at
+ * most one pending deadline: scheduling it again replaces the previous one
+ * (the old slot entry is dropped lazily when its slot is reached).
+ *
+ * A timer never fires before its deadline, and fires at most one tick after
+ * it once advance() is called. Not thread-safe.
+ */
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructor
+     * @param tick Resolution of the wheel
+     * @param origin Time of tick zero
+     */
+    TimerWheel(Clock::duration tick, Clock::time_point origin);
+
+    /**
+     * @brief Schedule (or reschedule) a key
+     * @param key Timer ID
+     * @param deadline Fire at or after this time
+     */
+    void schedule(uint64_t key, Clock::time_point deadline);
+
+    /**
+     * @brief Cancel a pending key (no-op if not scheduled)
+     */
+    void cancel(uint64_t key);
+
+    /**
+     * @brief Advance the wheel to now
+     * @param now Current time
+     * @param expired Receives the keys whose deadline has passed
+     */
+    void advance(Clock::time_point now, std::vector<uint64_t>& expired);
+
+    /**
+     * @brief When advance() should next be called
+     * @param when Set to the next time a slot may hold due timers
+     * @return false if nothing is scheduled
+     */
+    bool next_wakeup(Clock::time_point& when) const;
+
+    /**
+     * @brief Number of pending keys
+     */
+    size_t size() const { return deadlines_.size(); }
+
+private:
+    static constexpr int LEVELS = 3;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr uint64_t SLOTS = 1ULL << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint64_t MAX_DELTA = (1ULL << (SLOT_BITS * LEVELS)) - 1;
+
+    struct Timer {
+        uint64_t key;
+        uint64_t deadline_tick;
+    };
+
+    Clock::duration tick_;
+    Clock::time_point origin_;
+    uint64_t current_tick_;
+
+    std::vector<Timer> slots_[LEVELS][SLOTS];
+    size_t level_entries_[LEVELS];                  // Including stale entries
+    std::unordered_map<uint64_t, uint64_t> deadlines_;  // Key -> live deadline tick
+
+    void place(const Timer& timer);
+    bool is_live(const Timer& timer) const;
+};
+
+} // namespace miot
+
+#endif // TIMER_WHEEL_H
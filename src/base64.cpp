@@ -0,0 +1,495 @@
+/**
+ * Base64 Codec - Implementation
+ *
+ * The SIMD kernels only handle whole blocks in the middle of the input and
+ * hand the rest (tail, padding, invalid characters) to the scalar code, so
+ * every kernel produces exactly the scalar result.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "base64.h"
+
+#include <atomic>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BASE64_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace miot {
+
+namespace {
+
+const char ENCODE_TABLE[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+const uint8_t INVALID = 0xFF;
+
+struct DecodeTable {
+    uint8_t values[256];
+
+    DecodeTable() {
+        for (int i = 0; i < 256; i++) {
+            values[i] = INVALID;
+        }
+        for (int i = 0; i < 64; i++) {
+            values[static_cast<uint8_t>(ENCODE_TABLE[i])] = static_cast<uint8_t>(i);
+        }
+    }
+};
+
+const DecodeTable DECODE_TABLE;
+
+// Bulk kernels return how much input they consumed: whole 3-byte groups for
+// encoding, whole 4-character groups for decoding
+using EncodeKernel = size_t (*)(const uint8_t* in, size_t len, char* out);
+using DecodeKernel = size_t (*)(const char* in, size_t len, uint8_t* out);
+
+size_t encode_scalar(const uint8_t* in, size_t len, char* out) {
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t triple = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) | in[i + 2];
+        *out++ = ENCODE_TABLE[(triple >> 18) & 0x3F];
+        *out++ = ENCODE_TABLE[(triple >> 12) & 0x3F];
+        *out++ = ENCODE_TABLE[(triple >> 6) & 0x3F];
+        *out++ = ENCODE_TABLE[triple & 0x3F];
+    }
+    return i;
+}
+
+size_t decode_scalar(const char* in, size_t len, uint8_t* out) {
+    const uint8_t* table = DECODE_TABLE.values;
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(in);
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        uint8_t a = table[src[i]];
+        uint8_t b = table[src[i + 1]];
+        uint8_t c = table[src[i + 2]];
+        uint8_t d = table[src[i + 3]];
+        if ((a | b | c | d) & 0x80) {
+            break;
+        }
+        uint32_t triple = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+        *out++ = static_cast<uint8_t>(triple >> 16);
+        *out++ = static_cast<uint8_t>(triple >> 8);
+        *out++ = static_cast<uint8_t>(triple);
+    }
+    return i;
+}
+
+#if defined(BASE64_X86)
+
+// 12 input bytes -> 16 six-bit indices, one per byte
+__attribute__((target("ssse3")))
+inline __m128i enc_reshuffle(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+    __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+    __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+// Six-bit indices -> ASCII, by adding a per-range offset
+__attribute__((target("ssse3")))
+inline __m128i enc_translate(__m128i in) {
+    const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    __m128i indices = _mm_subs_epu8(in, _mm_set1_epi8(51));
+    __m128i mask = _mm_cmpgt_epi8(in, _mm_set1_epi8(25));
+    indices = _mm_sub_epi8(indices, mask);
+    return _mm_add_epi8(in, _mm_shuffle_epi8(lut, indices));
+}
+
+__attribute__((target("ssse3")))
+size_t encode_ssse3(const uint8_t* in, size_t len, char* out) {
+    size_t i = 0;
+    // Each step loads 16 bytes and uses 12
+    for (; i + 16 <= len; i += 12) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        block = enc_translate(enc_reshuffle(block));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+        out += 16;
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+size_t encode_avx2(const uint8_t* in, size_t len, char* out) {
+    const __m256i shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i lut = _mm256_setr_epi8(
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+    size_t i = 0;
+    // Two 12-byte groups per step, one per 128-bit lane
+    for (; i + 28 <= len; i += 24) {
+        __m256i block = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12)), 1);
+
+        block = _mm256_shuffle_epi8(block, shuffle);
+        __m256i t0 = _mm256_and_si256(block, _mm256_set1_epi32(0x0FC0FC00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(block, _mm256_set1_epi32(0x003F03F0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t1, t3);
+
+        __m256i offsets = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        offsets = _mm256_sub_epi8(offsets, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+        block = _mm256_add_epi8(indices, _mm256_shuffle_epi8(lut, offsets));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), block);
+        out += 32;
+    }
+    // The tail kernel is legacy-SSE encoded: clear the upper halves first to avoid the transition stall
+    _mm256_zeroupper();
+    return i + encode_ssse3(in + i, len - i, out);
+}
+
+// 16 characters -> 12 bytes (stored as 16); false if any character is outside the alphabet
+__attribute__((target("ssse3")))
+inline bool dec_block_ssse3(__m128i in, __m128i& out) {
+    const __m128i lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_0f = _mm_set1_epi8(0x0F);
+
+    __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_0f);
+    __m128i lo_nibbles = _mm_and_si128(in, mask_0f);
+    __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+
+    __m128i eq_2f = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2F));
+    __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+    __m128i values = _mm_add_epi8(in, roll);
+
+    // Pack four 6-bit values per 32-bit word, then drop the empty bytes
+    __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    out = _mm_shuffle_epi8(merged, _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    return true;
+}
+
+__attribute__((target("ssse3")))
+size_t decode_ssse3(const char* in, size_t len, uint8_t* out) {
+    size_t i = 0;
+    // Stores are 16 bytes wide for 12 decoded ones; 24 characters left
+    // guarantees the caller's buffer has room
+    for (; i + 24 <= len; i += 16) {
+        __m128i block;
+        if (!dec_block_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), block)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+        out += 12;
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+size_t decode_avx2(const char* in, size_t len, uint8_t* out) {
+    const __m256i lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i pack = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i mask_0f = _mm256_set1_epi8(0x0F);
+
+    size_t i = 0;
+    // 32-byte stores for 24 decoded bytes, same margin rule as SSSE3
+    for (; i + 48 <= len; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(block, 4), mask_0f);
+        __m256i lo_nibbles = _mm256_and_si256(block, mask_0f);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+
+        __m256i eq_2f = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(0x2F));
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        __m256i values = _mm256_add_epi8(block, roll);
+
+        __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        merged = _mm256_shuffle_epi8(merged, pack);
+        merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), merged);
+        out += 24;
+    }
+    _mm256_zeroupper();
+    return i + decode_ssse3(in + i, len - i, out);
+}
+
+#elif defined(BASE64_NEON)
+
+size_t encode_neon(const uint8_t* in, size_t len, char* out) {
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8(reinterpret_cast<const uint8_t*>(ENCODE_TABLE));
+    table.val[1] = vld1q_u8(reinterpret_cast<const uint8_t*>(ENCODE_TABLE) + 16);
+    table.val[2] = vld1q_u8(reinterpret_cast<const uint8_t*>(ENCODE_TABLE) + 32);
+    table.val[3] = vld1q_u8(reinterpret_cast<const uint8_t*>(ENCODE_TABLE) + 48);
+    const uint8x16_t mask_3f = vdupq_n_u8(0x3F);
+
+    size_t i = 0;
+    // 48 bytes de-interleaved into three registers -> 64 characters
+    for (; i + 48 <= len; i += 48) {
+        uint8x16x3_t src = vld3q_u8(in + i);
+        uint8x16x4_t indices;
+        indices.val[0] = vshrq_n_u8(src.val[0], 2);
+        indices.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(src.val[1], 4), vshlq_n_u8(src.val[0], 4)), mask_3f);
+        indices.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(src.val[2], 6), vshlq_n_u8(src.val[1], 2)), mask_3f);
+        indices.val[3] = vandq_u8(src.val[2], mask_3f);
+
+        uint8x16x4_t chars;
+        chars.val[0] = vqtbl4q_u8(table, indices.val[0]);
+        chars.val[1] = vqtbl4q_u8(table, indices.val[1]);
+        chars.val[2] = vqtbl4q_u8(table, indices.val[2]);
+        chars.val[3] = vqtbl4q_u8(table, indices.val[3]);
+        vst4q_u8(reinterpret_cast<uint8_t*>(out), chars);
+        out += 64;
+    }
+    return i;
+}
+
+// Characters -> six-bit values; invalid lanes are flagged in error
+inline uint8x16_t dec_lane_neon(uint8x16_t c, uint8x16_t& error) {
+    uint8x16_t upper = vsubq_u8(c, vdupq_n_u8('A'));
+    uint8x16_t lower = vsubq_u8(c, vdupq_n_u8('a'));
+    uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t is_upper = vcltq_u8(upper, vdupq_n_u8(26));
+    uint8x16_t is_lower = vcltq_u8(lower, vdupq_n_u8(26));
+    uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+    uint8x16_t is_plus = vceqq_u8(c, vdupq_n_u8('+'));
+    uint8x16_t is_slash = vceqq_u8(c, vdupq_n_u8('/'));
+
+    uint8x16_t value = vandq_u8(is_upper, upper);
+    value = vorrq_u8(value, vandq_u8(is_lower, vaddq_u8(lower, vdupq_n_u8(26))));
+    value = vorrq_u8(value, vandq_u8(is_digit, vaddq_u8(digit, vdupq_n_u8(52))));
+    value = vorrq_u8(value, vandq_u8(is_plus, vdupq_n_u8(62)));
+    value = vorrq_u8(value, vandq_u8(is_slash, vdupq_n_u8(63)));
+
+    uint8x16_t valid = vorrq_u8(vorrq_u8(is_upper, is_lower), vorrq_u8(is_digit, vorrq_u8(is_plus, is_slash)));
+    error = vorrq_u8(error, vmvnq_u8(valid));
+    return value;
+}
+
+size_t decode_neon(const char* in, size_t len, uint8_t* out) {
+    size_t i = 0;
+    // 64 characters de-interleaved into four registers -> 48 bytes
+    for (; i + 64 <= len; i += 64) {
+        uint8x16x4_t src = vld4q_u8(reinterpret_cast<const uint8_t*>(in + i));
+        uint8x16_t error = vdupq_n_u8(0);
+        uint8x16_t a = dec_lane_neon(src.val[0], error);
+        uint8x16_t b = dec_lane_neon(src.val[1], error);
+        uint8x16_t c = dec_lane_neon(src.val[2], error);
+        uint8x16_t d = dec_lane_neon(src.val[3], error);
+        if (vmaxvq_u8(error) != 0) {
+            break;
+        }
+
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(out, bytes);
+        out += 48;
+    }
+    return i;
+}
+
+#endif
+
+struct Kernels {
+    const char* name;
+    EncodeKernel encode;
+    DecodeKernel decode;
+    bool (*supported)();
+};
+
+bool always_supported() {
+    return true;
+}
+
+#if defined(BASE64_X86)
+bool avx2_supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool ssse3_supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+}
+#endif
+
+// Fastest first; scalar is always last and always usable
+const Kernels KERNELS[] = {
+#if defined(BASE64_X86)
+    {"avx2", encode_avx2, decode_avx2, avx2_supported},
+    {"ssse3", encode_ssse3, decode_ssse3, ssse3_supported},
+#elif defined(BASE64_NEON)
+    {"neon", encode_neon, decode_neon, always_supported},
+#endif
+    {"scalar", encode_scalar, decode_scalar, always_supported},
+};
+
+const Kernels* select_kernels() {
+    for (const Kernels& candidate : KERNELS) {
+        if (candidate.supported()) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+std::atomic<const Kernels*>& active_kernels() {
+    static std::atomic<const Kernels*> active(select_kernels());
+    return active;
+}
+
+const Kernels& kernels() {
+    return *active_kernels().load(std::memory_order_relaxed);
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+} // anonymous namespace
+
+void Base64::encode(const uint8_t* data, size_t len, char* out) {
+    size_t done = kernels().encode(data, len, out);
+    done += encode_scalar(data + done, len - done, out + done / 3 * 4);
+    out += done / 3 * 4;
+
+    size_t rest = len - done;
+    if (rest == 1) {
+        uint32_t value = uint32_t(data[done]) << 16;
+        out[0] = ENCODE_TABLE[(value >> 18) & 0x3F];
+        out[1] = ENCODE_TABLE[(value >> 12) & 0x3F];
+        out[2] = '=';
+        out[3] = '=';
+    } else if (rest == 2) {
+        uint32_t value = (uint32_t(data[done]) << 16) | (uint32_t(data[done + 1]) << 8);
+        out[0] = ENCODE_TABLE[(value >> 18) & 0x3F];
+        out[1] = ENCODE_TABLE[(value >> 12) & 0x3F];
+        out[2] = ENCODE_TABLE[(value >> 6) & 0x3F];
+        out[3] = '=';
+    }
+}
+
+std::string Base64::encode(const uint8_t* data, size_t len) {
+    std::string result(encoded_size(len), '\0');
+    encode(data, len, &result[0]);
+    return result;
+}
+
+bool Base64::decode(const char* data, size_t len, uint8_t* out, size_t& out_len) {
+    out_len = 0;
+
+    while (len > 0 && is_space(data[len - 1])) {
+        len--;
+    }
+    for (int pad = 0; pad < 2 && len > 0 && data[len - 1] == '='; pad++) {
+        len--;
+    }
+    if (len % 4 == 1) {
+        return false;
+    }
+
+    size_t done = kernels().decode(data, len, out);
+    done += decode_scalar(data + done, len - done, out + done / 4 * 3);
+    size_t written = done / 4 * 3;
+
+    // Whatever is left is either a short final group or an invalid character
+    size_t rest = len - done;
+    if (rest >= 4) {
+        return false;
+    }
+    if (rest > 0) {
+        const uint8_t* table = DECODE_TABLE.values;
+        const uint8_t* src = reinterpret_cast<const uint8_t*>(data + done);
+        uint8_t a = table[src[0]];
+        uint8_t b = table[src[1]];
+        uint8_t c = rest == 3 ? table[src[2]] : 0;
+        if ((a | b | c) & 0x80) {
+            return false;
+        }
+        uint32_t value = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6);
+        out[written++] = static_cast<uint8_t>(value >> 16);
+        if (rest == 3) {
+            out[written++] = static_cast<uint8_t>(value >> 8);
+        }
+    }
+
+    out_len = written;
+    return true;
+}
+
+bool Base64::decode(const std::string& encoded, std::vector<uint8_t>& out) {
+    out.resize(decoded_max_size(encoded.size()));
+    size_t out_len = 0;
+    if (!decode(encoded.data(), encoded.size(), out.data(), out_len)) {
+        out.clear();
+        return false;
+    }
+    out.resize(out_len);
+    return true;
+}
+
+const char* Base64::implementation() {
+    return kernels().name;
+}
+
+std::vector<const char*> Base64::implementations() {
+    std::vector<const char*> names;
+    for (const Kernels& candidate : KERNELS) {
+        if (candidate.supported()) {
+            names.push_back(candidate.name);
+        }
+    }
+    return names;
+}
+
+bool Base64::set_implementation(const char* name) {
+    for (const Kernels& candidate : KERNELS) {
+        if (std::strcmp(candidate.name, name) == 0 && candidate.supported()) {
+            active_kernels().store(&candidate, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace miot
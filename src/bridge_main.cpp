@@ -5,11 +5,18 @@
 #include "miot_cloud_client.h"
 #include "miot_camera_client.h"
 #include "gst_rtsp_server.h"
+#include "startup_orchestrator.h"
+#include "device_cache.h"
+#include "device_event_dispatcher.h"
 
 #include <iostream>
 #include <string>
 #include <thread>
 #include <chrono>
+#include <mutex>
+#include <set>
+#include <future>
+#include <algorithm>
 
 using namespace miot;
 
@@ -17,17 +24,43 @@ const std::string CLIENT_ID = "2882303761520431603";
 const std::string REDIRECT_URI = "https://mico.api.mijia.tech/login_redirect";
 const std::string CLOUD_SERVER = "cn";
 const std::string TOKEN_FILE = "miot_token.json";
+const std::string DEVICE_CACHE_FILE = "miot_devices.json";
+
+// 按需推流：有 RTSP 客户端时才拉取摄像头，最后一个客户端离开 IDLE_LINGER 后停止
+const bool ON_DEMAND_STREAMING = true;
+const std::chrono::seconds IDLE_LINGER(30);
+
+// 摄像头离线判定比其他设备更快，以便及时移除挂载点（秒）
+const std::string CAMERA_DEVICE_CLASS = "camera";
+const double CAMERA_OFFLINE_TIMEOUT = 150.0;
 
 struct CameraBridgeContext {
     std::shared_ptr<MiotOAuth> oauth;
     std::shared_ptr<MIoTCloudClient> cloud_client;
     std::shared_ptr<MIoTLanDiscovery> discovery;
     std::shared_ptr<MIoTCameraClient> camera_client;
+    // 已知设备的局域网地址和云端信息，重启后直接使用
+    std::shared_ptr<DeviceCache> device_cache;
+    
+    // 设备事件在多个 worker 线程上并发处理（同一设备有序）
+    std::mutex cloud_devices_mutex;
     std::map<std::string, std::shared_ptr<CloudDeviceInfo>> cloud_devices;
-    std::map<std::string, std::shared_ptr<GstRtspServer>> rtsp_servers;
+    std::shared_ptr<GstRtspServer> rtsp_server;
+    
+    // 以下状态由设备事件 worker 和摄像头启停 worker 共享
+    std::mutex stream_mutex;
+    std::map<std::string, std::string> camera_mounts;  // did -> RTSP 挂载点
+    std::set<std::string> streaming_cameras;           // 正在拉流的摄像头
+    
+    // RTSP 客户端变化引起的摄像头启停（P2P 建连会阻塞）在这里执行，不占用 GMainLoop
+    DeviceEventDispatcher stream_dispatcher;
 };
 CameraBridgeContext camera_bridge_context;
 
+// 启动完成（true）或失败（false）后兑现；设备事件处理前先等待它
+std::promise<bool> services_ready_promise;
+std::shared_future<bool> services_ready = services_ready_promise.get_future().share();
+
 // 添加到 miot_camera_client.h 或单独的工具文件
 
 /**
@@ -105,33 +138,146 @@ inline bool is_h264_keyframe(const uint8_t* data, size_t size) {
     return nal_unit_type == 5 || nal_unit_type == 7 || nal_unit_type == 8;
 }
 
+/**
+ * @brief 为摄像头生成唯一的 RTSP 挂载点
+ * 
+ * 优先使用云端名称（如 "/living_room"），名称不可用或重名时使用 DID。
+ */
+std::string make_camera_mount(const std::string& did, const CloudDeviceInfo& info) {
+    std::string mount = GstRtspServer::make_mount_point(info.name);
+    if (mount.empty()) {
+        return "/" + did;
+    }
+    
+    for (const auto& pair : camera_bridge_context.camera_mounts) {
+        if (pair.first != did && pair.second == mount) {
+            return mount + "_" + did;
+        }
+    }
+    return mount;
+}
+
+/**
+ * @brief 获取设备的云端名称，未知设备返回 DID
+ */
+std::string get_device_name(const std::string& did) {
+    std::lock_guard<std::mutex> lock(camera_bridge_context.cloud_devices_mutex);
+    auto it = camera_bridge_context.cloud_devices.find(did);
+    return it != camera_bridge_context.cloud_devices.end() ? it->second->name : did;
+}
+
+/**
+ * @brief 开始拉取摄像头（已在拉流时忽略），需持有 stream_mutex
+ */
+void start_camera_stream(const std::string& did) {
+    if (!camera_bridge_context.streaming_cameras.insert(did).second) {
+        return;
+    }
+    
+    // 启用音频
+    if (!camera_bridge_context.camera_client->start_camera(did, "", VideoQuality::HIGH, true)) {
+        camera_bridge_context.streaming_cameras.erase(did);
+        return;
+    }
+    std::cout << "[CameraStream] Camera started: " << did << std::endl;
+}
+
+/**
+ * @brief 停止拉取摄像头并丢弃挂载点的 GOP 缓存，需持有 stream_mutex
+ */
+void stop_camera_stream(const std::string& did) {
+    if (!camera_bridge_context.streaming_cameras.erase(did)) {
+        return;
+    }
+    
+    camera_bridge_context.camera_client->stop_camera(did);
+    
+    // 重新开始拉流后旧 GOP 的时间戳不再连续，不能回放给新客户端
+    auto mount_it = camera_bridge_context.camera_mounts.find(did);
+    if (mount_it != camera_bridge_context.camera_mounts.end()) {
+        camera_bridge_context.rtsp_server->reset_mount(mount_it->second);
+    }
+    std::cout << "[CameraStream] Camera stopped: " << did << std::endl;
+}
+
+/**
+ * @brief RTSP 客户端状态变化（GMainLoop 线程）：第一个客户端连接时开始拉流，空闲后停止
+ * 
+ * 只把变化交给 stream_dispatcher，同一挂载点按顺序处理；这里不能加锁或阻塞，
+ * 否则一个摄像头建连期间整个 RTSP 服务器都会停顿
+ */
+void client_presence_callback(const std::string& mount_point, bool active) {
+    bool posted = camera_bridge_context.stream_dispatcher.post(mount_point, [mount_point, active]() {
+        std::lock_guard<std::mutex> lock(camera_bridge_context.stream_mutex);
+        for (const auto& pair : camera_bridge_context.camera_mounts) {
+            if (pair.second != mount_point) {
+                continue;
+            }
+            
+            if (active) {
+                start_camera_stream(pair.first);
+            } else {
+                stop_camera_stream(pair.first);
+            }
+            return;
+        }
+    });
+    if (!posted) {
+        std::cerr << "[CameraStream] Dropped presence change for " << mount_point << std::endl;
+    }
+}
+
 void device_status_changed_callback(const std::string& did, const DeviceInfo& info) {
-    std::shared_ptr<CloudDeviceInfo> cloud_device_info;
+    // 局域网发现先于token和客户端启动，事件在此等待启动完成
+    if (!services_ready.get()) {
+        return;
+    }
+    
+    // 地址变化（以及新设备）写入缓存
+    if (info.status_changed_type != DeviceStatusChangedType::OFFLINE) {
+        camera_bridge_context.device_cache->update_lan(info);
+    }
+    
     switch (info.status_changed_type) {
         case DeviceStatusChangedType::NEW:{
-            
-
-            auto cloud_device_info = camera_bridge_context.cloud_client->get_device(did);
-            camera_bridge_context.cloud_devices[did] = std::make_shared<CloudDeviceInfo>(cloud_device_info);
+            // 已缓存的设备不必等待云端查询，缓存在启动后会在后台刷新
+            CloudDeviceInfo cloud_device_info;
+            if (!camera_bridge_context.device_cache->get_cloud_info(did, cloud_device_info)) {
+                cloud_device_info = camera_bridge_context.cloud_client->get_device(did);
+                if (!cloud_device_info.model.empty()) {
+                    camera_bridge_context.device_cache->update_cloud(cloud_device_info);
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(camera_bridge_context.cloud_devices_mutex);
+                camera_bridge_context.cloud_devices[did] = std::make_shared<CloudDeviceInfo>(cloud_device_info);
+            }
 
             std::cout << "[DeviceStatusChangedCallback] Device is new " << did << " " << cloud_device_info.model << std::endl;
 
             if (cloud_device_info.model == "chuangmi.camera.029a02") {
+                camera_bridge_context.discovery->set_device_class(did, CAMERA_DEVICE_CLASS);
                 camera_bridge_context.camera_client->create_camera(did, cloud_device_info.model, 1);
             
+                std::lock_guard<std::mutex> lock(camera_bridge_context.stream_mutex);
+                std::string mount = make_camera_mount(did, cloud_device_info);
+                camera_bridge_context.camera_mounts[did] = mount;
+                camera_bridge_context.rtsp_server->add_mount(mount);
+                std::cout << "[DeviceStatusChangedCallback] RTSP Stream URL: " 
+                          << camera_bridge_context.rtsp_server->get_url(mount) << std::endl;
 
-                camera_bridge_context.camera_client->register_raw_video_callback(did, 0, [](const std::string& did, const RawFrameData& frame) {
+                camera_bridge_context.camera_client->register_raw_video_callback(did, 0, [mount](const std::string& did, const RawFrameData& frame) {
                     
                     bool is_keyframe = false;
         
                     if (frame.codec_id == CameraCodec::VIDEO_H265) {
-                        is_keyframe = is_h265_keyframe(frame.data.data(), frame.data.size());
+                        is_keyframe = is_h265_keyframe(frame.data(), frame.size());
                     } else if (frame.codec_id == CameraCodec::VIDEO_H264) {
-                        is_keyframe = is_h264_keyframe(frame.data.data(), frame.data.size());
+                        is_keyframe = is_h264_keyframe(frame.data(), frame.size());
                     }
 
-                    // std::cout << "[RawVideoCallback] Received frame: " << frame.data.size() << " bytes, timestamp: " << frame.timestamp << ", frame_type: " << is_keyframe << std::endl;
-                    camera_bridge_context.rtsp_servers["/xiaomi_camera"]->push_video_frame(frame.data, frame.timestamp, is_keyframe);
+                    // std::cout << "[RawVideoCallback] Received frame: " << frame.size() << " bytes, timestamp: " << frame.timestamp << ", frame_type: " << is_keyframe << std::endl;
+                    camera_bridge_context.rtsp_server->push_video_frame(mount, frame.codec_id, frame.buffer, frame.timestamp, is_keyframe);
                 });
 
                 camera_bridge_context.camera_client->register_status_callback(did, [](const std::string& did, CameraStatus status) {
@@ -139,35 +285,45 @@ void device_status_changed_callback(const std::string& did, const DeviceInfo& in
                 });
 
                 // 注册音频回调
-                camera_bridge_context.camera_client->register_raw_audio_callback(did, 0, [](const std::string& did, const RawFrameData& frame) {
+                camera_bridge_context.camera_client->register_raw_audio_callback(did, 0, [mount](const std::string& did, const RawFrameData& frame) {
                     static int audio_frame_count = 0;
                     if (audio_frame_count++ < 5) {
-                        std::cout << "[RawAudioCallback] Received audio frame: " << frame.data.size() 
+                        std::cout << "[RawAudioCallback] Received audio frame: " << frame.size() 
                                   << " bytes, codec: " << static_cast<int>(frame.codec_id)
                                   << ", timestamp: " << frame.timestamp << std::endl;
                     }
                     
                     // 推送音频帧到 RTSP
-                    camera_bridge_context.rtsp_servers["/xiaomi_camera"]->push_audio_frame(frame.data, frame.timestamp);
+                    camera_bridge_context.rtsp_server->push_audio_frame(mount, frame.codec_id, frame.buffer, frame.timestamp);
                 });
 
-                // 启用音频
-                camera_bridge_context.camera_client->start_camera(did, "", VideoQuality::HIGH, true);
-
-                std::cout << "[DeviceStatusChangedCallback] Camera started" << std::endl;   
+                // 先拉流一次以确定编码并对外提供挂载点；按需模式下无人连接时 IDLE_LINGER 后自动停止
+                start_camera_stream(did);
             }
             break;
         }
-        case DeviceStatusChangedType::ONLINE:
-            std::cout << "[DeviceStatusChangedCallback] Device " << camera_bridge_context.cloud_devices[did]->name << " is online" << std::endl;
-            camera_bridge_context.camera_client->start_camera(did, "", VideoQuality::HIGH, true);
+        case DeviceStatusChangedType::ONLINE: {
+            std::cout << "[DeviceStatusChangedCallback] Device " << get_device_name(did) << " is online" << std::endl;
+            std::lock_guard<std::mutex> lock(camera_bridge_context.stream_mutex);
+            auto mount_it = camera_bridge_context.camera_mounts.find(did);
+            if (mount_it != camera_bridge_context.camera_mounts.end()) {
+                camera_bridge_context.rtsp_server->add_mount(mount_it->second);
+                start_camera_stream(did);
+            }
             break;
-        case DeviceStatusChangedType::OFFLINE:
-            std::cout << "[DeviceStatusChangedCallback] Device " << camera_bridge_context.cloud_devices[did]->name << " is offline" << std::endl;
-            camera_bridge_context.camera_client->stop_camera(did);
+        }
+        case DeviceStatusChangedType::OFFLINE: {
+            std::cout << "[DeviceStatusChangedCallback] Device " << get_device_name(did) << " is offline" << std::endl;
+            std::lock_guard<std::mutex> lock(camera_bridge_context.stream_mutex);
+            auto mount_it = camera_bridge_context.camera_mounts.find(did);
+            if (mount_it != camera_bridge_context.camera_mounts.end()) {
+                stop_camera_stream(did);
+                camera_bridge_context.rtsp_server->remove_mount(mount_it->second);
+            }
             break;
+        }
         case DeviceStatusChangedType::IP_CHANGED:
-            std::cout << "[DeviceStatusChangedCallback] Device " << camera_bridge_context.cloud_devices[did]->name << " IP changed to " << info.ip << std::endl;
+            std::cout << "[DeviceStatusChangedCallback] Device " << get_device_name(did) << " IP changed to " << info.ip << std::endl;
             break;
         case DeviceStatusChangedType::INTERFACE_CHANGED:
             break;
@@ -179,44 +335,137 @@ void device_status_changed_callback(const std::string& did, const DeviceInfo& in
 
 
 int main() {
-    // 创建一个MiotOAuth实例，并且进行token有效性的监控
+    // 启动分成若干阶段并发执行，每个阶段只等待它依赖的阶段
+    StartupOrchestrator startup;
+    
     std::shared_ptr<MiotOAuth> oauth = std::make_shared<MiotOAuth>(CLIENT_ID, REDIRECT_URI, CLOUD_SERVER, TOKEN_FILE);
-
-    camera_bridge_context.oauth = oauth;
-
-    oauth->start_auth_flow();
-
+    std::shared_ptr<MIoTCameraClient> camera_client = std::make_shared<MIoTCameraClient>(CLOUD_SERVER, "");
+    // 一个 RTSP 服务器承载所有摄像头，每个摄像头在发现时添加自己的挂载点
+    std::shared_ptr<GstRtspServer> rtsp_server = std::make_shared<GstRtspServer>(8554);
+    std::shared_ptr<MIoTLanDiscovery> discovery = std::make_shared<MIoTLanDiscovery>();
+    std::shared_ptr<MIoTCloudClient> cloud_client;
+    std::shared_ptr<DeviceCache> device_cache = std::make_shared<DeviceCache>(DEVICE_CACHE_FILE);
     TokenInfo token;
-    bool success = oauth->get_token(token);
-    if (!success) {
-        std::cerr << "Failed to get token" << std::endl;
-        return 1;
-    }
-
-    // 创建一个MIoTCloudClient实例，完成初始化，并且能够更新token
-    std::shared_ptr<MIoTCloudClient> cloud_client = std::make_shared<MIoTCloudClient>(token.access_token);
-    cloud_client->init();
+    
+    // 不需要token的阶段：GStreamer初始化、加载摄像头库、局域网发现、加载/获取token
+    startup.add_stage("gstreamer", {}, [&]() {
+        return rtsp_server->init();
+    });
+    startup.add_stage("camera_library", {}, [&]() {
+        return camera_client->load();
+    });
+    startup.add_stage("device_cache", {}, [&]() {
+        // 缓存损坏不影响启动，只是退回到完整的发现流程
+        device_cache->load();
+        return true;
+    });
+    startup.add_stage("discovery", {"device_cache"}, [&]() {
+        // 设备事件会先排队，等所有服务就绪后再处理
+        // NEW 事件会阻塞等待云端查询，足够多的 worker 才能让一批设备合并成一次请求
+        discovery->set_event_workers(16);
+        discovery->set_class_timeout(CAMERA_DEVICE_CLASS, CAMERA_OFFLINE_TIMEOUT);
+        discovery->register_callback("device_status_changed_callback", device_status_changed_callback);
+        if (!discovery->start()) {
+            return false;
+        }
+        // 已知设备直接单播探测，不必等待首次广播；上次所在的接口还在就只从该接口发送
+        for (const auto& device : device_cache->get_devices()) {
+            if (!device.ip.empty()) {
+                bool known_interface = !device.interface.empty() && discovery->has_interface(device.interface);
+                discovery->ping(known_interface ? device.interface : "", device.ip);
+            }
+        }
+        return true;
+    });
+    startup.add_stage("token", {}, [&]() {
+        // 加载token，必要时走授权流程，之后持续自动刷新
+        oauth->start_auth_flow();
+        return oauth->get_token(token);
+    });
+    
+    // 依赖其他阶段的部分
+    // 客户端一创建就订阅token刷新，启动期间的刷新也能送达；订阅后再取一次最新token，
+    // 补上 token 阶段结束到订阅之间的刷新
+    startup.add_stage("cloud_client", {"token"}, [&]() {
+        auto client = std::make_shared<MIoTCloudClient>(token.access_token, CLOUD_SERVER);
+        oauth->subscribe_token([client](const TokenInfo& refreshed) {
+            client->set_access_token(refreshed.access_token);
+        });
+        TokenInfo latest;
+        if (oauth->get_token(latest)) {
+            client->set_access_token(latest.access_token);
+        }
+        cloud_client = client;
+        return cloud_client->init();
+    });
+    startup.add_stage("camera_client", {"camera_library", "token"}, [&]() {
+        oauth->subscribe_token([camera_client](const TokenInfo& refreshed) {
+            camera_client->update_access_token(refreshed.access_token);
+        });
+        TokenInfo latest = token;
+        oauth->get_token(latest);
+        camera_client->update_access_token(latest.access_token);
+        return camera_client->init();
+    });
+    startup.add_stage("rtsp_server", {"gstreamer"}, [&]() {
+        if (ON_DEMAND_STREAMING) {
+            camera_bridge_context.stream_dispatcher.start();
+            rtsp_server->set_client_presence_callback(client_presence_callback, IDLE_LINGER);
+        }
+        return rtsp_server->start();
+    });
+    
+    bool started = startup.run();
+    
+    camera_bridge_context.oauth = oauth;
     camera_bridge_context.cloud_client = cloud_client;
-
-    std::shared_ptr<MIoTCameraClient> camera_client = std::make_shared<MIoTCameraClient>("cn", token.access_token);
-    camera_client->init();
     camera_bridge_context.camera_client = camera_client;
-
-    std::shared_ptr<GstRtspServer> rtsp_server = std::make_shared<GstRtspServer>(8554, "/xiaomi_camera");
-    rtsp_server->init();
-    camera_bridge_context.rtsp_servers["/xiaomi_camera"] = rtsp_server;
-    rtsp_server->start();
-    std::cout << "RTSP Stream URL: " << rtsp_server->get_url() << std::endl;
-    
-    // 创建一个MIoTLanDiscovery
-    std::shared_ptr<MIoTLanDiscovery> discovery = std::make_shared<MIoTLanDiscovery>();
+    camera_bridge_context.rtsp_server = rtsp_server;
     camera_bridge_context.discovery = discovery;
-    discovery->register_callback("device_status_changed_callback", device_status_changed_callback);
-    discovery->start();
+    camera_bridge_context.device_cache = device_cache;
+    // 放行排队中的设备事件（启动失败时事件会被丢弃）
+    services_ready_promise.set_value(started);
+    
+    if (!started) {
+        std::cerr << "Startup failed" << std::endl;
+        discovery->stop();
+        oauth->stop_auth_flow();
+        return 1;
+    }
+    
+    // 后台刷新缓存中的云端信息（名称、型号等可能在 App 中被修改）
+    std::vector<std::string> cached_dids;
+    for (const auto& device : device_cache->get_devices()) {
+        if (device.has_cloud_info) {
+            cached_dids.push_back(device.did);
+        }
+    }
+    if (!cached_dids.empty()) {
+        cloud_client->get_devices_async(cached_dids, [device_cache](std::map<std::string, CloudDeviceInfo> devices) {
+            for (const auto& pair : devices) {
+                device_cache->update_cloud(pair.second);
+            }
+        });
+    }
 
-    // 循环执行，等待结束
-    while (1) {
+    // 循环执行，等待结束；定期输出设备事件处理指标
+    for (int seconds = 1; ; seconds++) {
         std::this_thread::sleep_for(std::chrono::seconds(1));
+        
+        if (seconds % 60 == 0) {
+            DeviceEventStats stats = discovery->get_event_stats();
+            std::cout << "[DeviceEvents] dispatched " << stats.dispatched << "/" << stats.posted
+                      << ", queue depth " << stats.queue_depth << " (max " << stats.max_queue_depth << ")"
+                      << ", wait avg " << stats.avg_wait_us << " us"
+                      << ", handler avg " << stats.avg_handler_us << " us, max " << stats.max_handler_us << " us"
+                      << std::endl;
+            
+            // 快照不加锁，设备很多时也不会阻塞发现线程
+            auto devices = discovery->get_device_snapshot();
+            size_t online = std::count_if(devices->begin(), devices->end(),
+                                          [](const DeviceInfo& device) { return device.online; });
+            std::cout << "[Discovery] " << online << "/" << devices->size() << " devices online" << std::endl;
+        }
     }
 
     return 0;
@@ -0,0 +1,160 @@
+/**
+ * Cloud Crypto Context - Implementation
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "cloud_crypto.h"
+
+#include <openssl/pem.h>
+#include <openssl/bio.h>
+#include <openssl/rsa.h>
+#include <openssl/rand.h>
+
+#include <iostream>
+
+namespace miot {
+
+CloudCrypto::CloudCrypto()
+    : public_key_(nullptr),
+      encrypt_ctx_(nullptr),
+      decrypt_ctx_(nullptr)
+{
+}
+
+CloudCrypto::~CloudCrypto() {
+    reset();
+}
+
+void CloudCrypto::reset() {
+    if (encrypt_ctx_) {
+        EVP_CIPHER_CTX_free(encrypt_ctx_);
+        encrypt_ctx_ = nullptr;
+    }
+    if (decrypt_ctx_) {
+        EVP_CIPHER_CTX_free(decrypt_ctx_);
+        decrypt_ctx_ = nullptr;
+    }
+    if (public_key_) {
+        EVP_PKEY_free(public_key_);
+        public_key_ = nullptr;
+    }
+    key_.clear();
+}
+
+bool CloudCrypto::init(const char* public_key_pem) {
+    reset();
+
+    BIO* bio = BIO_new_mem_buf(public_key_pem, -1);
+    if (!bio) {
+        return false;
+    }
+    public_key_ = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
+    BIO_free(bio);
+    if (!public_key_) {
+        std::cerr << "[CloudCrypto] Failed to parse public key" << std::endl;
+        return false;
+    }
+
+    key_.resize(KEY_SIZE);
+    if (RAND_bytes(key_.data(), KEY_SIZE) != 1) {
+        std::cerr << "[CloudCrypto] Failed to generate session key" << std::endl;
+        reset();
+        return false;
+    }
+
+    // Key schedules are expanded here once; each request only resets the IV
+    encrypt_ctx_ = EVP_CIPHER_CTX_new();
+    decrypt_ctx_ = EVP_CIPHER_CTX_new();
+    if (!encrypt_ctx_ || !decrypt_ctx_ ||
+        EVP_EncryptInit_ex(encrypt_ctx_, EVP_aes_128_cbc(), nullptr, key_.data(), key_.data()) != 1 ||
+        EVP_DecryptInit_ex(decrypt_ctx_, EVP_aes_128_cbc(), nullptr, key_.data(), key_.data()) != 1) {
+        std::cerr << "[CloudCrypto] Failed to set up AES contexts" << std::endl;
+        reset();
+        return false;
+    }
+
+    // Padding is stripped by hand to keep the lenient reference behaviour
+    EVP_CIPHER_CTX_set_padding(decrypt_ctx_, 0);
+    return true;
+}
+
+std::vector<uint8_t> CloudCrypto::rsa_encrypt(const uint8_t* data, size_t len) const {
+    if (!public_key_) {
+        return {};
+    }
+
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new(public_key_, nullptr);
+    if (!ctx) {
+        return {};
+    }
+
+    std::vector<uint8_t> result;
+    size_t outlen = 0;
+    if (EVP_PKEY_encrypt_init(ctx) > 0 &&
+        EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_PADDING) > 0 &&
+        EVP_PKEY_encrypt(ctx, nullptr, &outlen, data, len) > 0) {
+        result.resize(outlen);
+        if (EVP_PKEY_encrypt(ctx, result.data(), &outlen, data, len) > 0) {
+            result.resize(outlen);
+        } else {
+            result.clear();
+        }
+    }
+
+    EVP_PKEY_CTX_free(ctx);
+    return result;
+}
+
+bool CloudCrypto::encrypt(const uint8_t* data, size_t len, std::vector<uint8_t>& out) {
+    if (!encrypt_ctx_) {
+        return false;
+    }
+
+    // Padding is written by the final call, straight into the same buffer
+    out.resize(padded_size(len));
+    int written = 0;
+    int final_len = 0;
+
+    std::lock_guard<std::mutex> lock(encrypt_mutex_);
+    if (EVP_EncryptInit_ex(encrypt_ctx_, nullptr, nullptr, nullptr, key_.data()) != 1 ||
+        EVP_EncryptUpdate(encrypt_ctx_, out.data(), &written, data, static_cast<int>(len)) != 1 ||
+        EVP_EncryptFinal_ex(encrypt_ctx_, out.data() + written, &final_len) != 1) {
+        out.clear();
+        return false;
+    }
+
+    out.resize(written + final_len);
+    return true;
+}
+
+bool CloudCrypto::decrypt(const uint8_t* data, size_t len, std::vector<uint8_t>& out) {
+    if (!decrypt_ctx_ || len == 0 || len % BLOCK_SIZE != 0) {
+        out.clear();
+        return false;
+    }
+
+    out.resize(len);
+    int written = 0;
+    int final_len = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(decrypt_mutex_);
+        if (EVP_DecryptInit_ex(decrypt_ctx_, nullptr, nullptr, nullptr, key_.data()) != 1 ||
+            EVP_DecryptUpdate(decrypt_ctx_, out.data(), &written, data, static_cast<int>(len)) != 1 ||
+            EVP_DecryptFinal_ex(decrypt_ctx_, out.data() + written, &final_len) != 1) {
+            out.clear();
+            return false;
+        }
+    }
+    out.resize(written + final_len);
+
+    uint8_t padding = out.back();
+    if (padding <= out.size() && padding <= BLOCK_SIZE) {
+        out.resize(out.size() - padding);
+    }
+    return true;
+}
+
+} // namespace miot
@@ -0,0 +1,225 @@
+/**
+ * Device Cache - Implementation
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "device_cache.h"
+
+#include <nlohmann/json.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace miot {
+
+namespace {
+
+const int CACHE_FORMAT_VERSION = 1;
+
+int64_t unix_now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// The cloud fields worth keeping across restarts (no secrets)
+json cloud_to_json(const CloudDeviceInfo& info) {
+    return {
+        {"name", info.name},
+        {"model", info.model},
+        {"urn", info.urn},
+        {"manufacturer", info.manufacturer},
+        {"fw_version", info.fw_version},
+        {"platform", info.platform},
+        {"is_set_pincode", info.is_set_pincode},
+        {"pincode_type", info.pincode_type},
+        {"home_id", info.home_id},
+        {"home_name", info.home_name},
+        {"room_id", info.room_id},
+        {"room_name", info.room_name}
+    };
+}
+
+CloudDeviceInfo cloud_from_json(const std::string& did, const json& j) {
+    CloudDeviceInfo info;
+    info.did = did;
+    info.name = j.value("name", "");
+    info.model = j.value("model", "");
+    info.urn = j.value("urn", "");
+    info.manufacturer = j.value("manufacturer", "");
+    info.fw_version = j.value("fw_version", "");
+    info.platform = j.value("platform", "");
+    info.is_set_pincode = j.value("is_set_pincode", 0);
+    info.pincode_type = j.value("pincode_type", 0);
+    info.home_id = j.value("home_id", "");
+    info.home_name = j.value("home_name", "");
+    info.room_id = j.value("room_id", "");
+    info.room_name = j.value("room_name", "");
+    return info;
+}
+
+} // anonymous namespace
+
+DeviceCache::DeviceCache(const std::string& path)
+    : path_(path)
+{
+}
+
+bool DeviceCache::load() {
+    std::ifstream file(path_);
+    if (!file.is_open()) {
+        std::cout << "[DeviceCache] No device cache at " << path_ << std::endl;
+        return true;
+    }
+
+    std::map<std::string, CachedDevice> devices;
+    try {
+        json root = json::parse(file);
+        if (root.value("version", 0) != CACHE_FORMAT_VERSION) {
+            std::cerr << "[DeviceCache] Ignoring cache with unknown format: " << path_ << std::endl;
+            return false;
+        }
+
+        for (const auto& entry : root.at("devices")) {
+            CachedDevice device;
+            device.did = entry.at("did").get<std::string>();
+            device.ip = entry.value("ip", "");
+            device.interface = entry.value("interface", "");
+            device.timestamp_offset = entry.value("timestamp_offset", int64_t(0));
+            device.last_seen = entry.value("last_seen", int64_t(0));
+            if (entry.contains("cloud") && entry["cloud"].is_object()) {
+                device.has_cloud_info = true;
+                device.cloud_info = cloud_from_json(device.did, entry["cloud"]);
+            }
+            devices[device.did] = device;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[DeviceCache] Failed to parse " << path_ << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_ = std::move(devices);
+    std::cout << "[DeviceCache] Loaded " << devices_.size() << " device(s) from " << path_ << std::endl;
+    return true;
+}
+
+std::vector<CachedDevice> DeviceCache::get_devices() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<CachedDevice> devices;
+    devices.reserve(devices_.size());
+    for (const auto& pair : devices_) {
+        devices.push_back(pair.second);
+    }
+    return devices;
+}
+
+bool DeviceCache::get_cloud_info(const std::string& did, CloudDeviceInfo& info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = devices_.find(did);
+    if (it == devices_.end() || !it->second.has_cloud_info) {
+        return false;
+    }
+    info = it->second.cloud_info;
+    return true;
+}
+
+void DeviceCache::update_lan(const DeviceInfo& info) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CachedDevice& device = devices_[info.did];
+    bool changed = device.did.empty() || device.ip != info.ip || device.interface != info.interface;
+
+    device.did = info.did;
+    device.ip = info.ip;
+    device.interface = info.interface;
+    device.timestamp_offset = info.timestamp_offset;
+    device.last_seen = unix_now();
+
+    // Offset and last-seen drift constantly and go out with the next real change
+    if (changed) {
+        save_locked();
+    }
+}
+
+void DeviceCache::update_cloud(const CloudDeviceInfo& info) {
+    if (info.did.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    CachedDevice& device = devices_[info.did];
+    device.did = info.did;
+    if (device.has_cloud_info && cloud_to_json(device.cloud_info) == cloud_to_json(info)) {
+        return;
+    }
+
+    device.has_cloud_info = true;
+    device.cloud_info = cloud_from_json(info.did, cloud_to_json(info));
+    save_locked();
+}
+
+bool DeviceCache::save() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return save_locked();
+}
+
+bool DeviceCache::save_locked() {
+    json devices = json::array();
+    for (const auto& pair : devices_) {
+        const CachedDevice& device = pair.second;
+        json entry = {
+            {"did", device.did},
+            {"ip", device.ip},
+            {"interface", device.interface},
+            {"timestamp_offset", device.timestamp_offset},
+            {"last_seen", device.last_seen}
+        };
+        if (device.has_cloud_info) {
+            entry["cloud"] = cloud_to_json(device.cloud_info);
+        }
+        devices.push_back(entry);
+    }
+    std::string content = json{{"version", CACHE_FORMAT_VERSION}, {"devices", devices}}.dump(2);
+
+    // Write a sibling file and rename it over the snapshot
+    std::string tmp_path = path_ + ".tmp";
+    FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "[DeviceCache] Failed to write " << tmp_path << std::endl;
+        return false;
+    }
+
+    bool ok = std::fwrite(content.data(), 1, content.size(), file) == content.size();
+    ok = std::fflush(file) == 0 && ok;
+#ifndef _WIN32
+    ok = fsync(fileno(file)) == 0 && ok;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows; MoveFileEx does so in one step
+    bool renamed = ok && MoveFileExA(tmp_path.c_str(), path_.c_str(),
+                                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool renamed = ok && std::rename(tmp_path.c_str(), path_.c_str()) == 0;
+#endif
+    if (!renamed) {
+        std::cerr << "[DeviceCache] Failed to save " << path_ << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace miot
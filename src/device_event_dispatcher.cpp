@@ -0,0 +1,160 @@
+/**
+ * Device Event Dispatcher - Implementation
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "device_event_dispatcher.h"
+
+#include <iostream>
+#include <algorithm>
+
+namespace miot {
+
+namespace {
+
+// Raise an atomic maximum
+template <typename T>
+void update_max(std::atomic<T>& target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t elapsed_us(std::chrono::steady_clock::time_point from,
+                    std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+} // anonymous namespace
+
+DeviceEventDispatcher::DeviceEventDispatcher(size_t worker_count)
+    : worker_count_(std::max<size_t>(worker_count, 1)),
+      running_(false),
+      posted_(0),
+      dispatched_(0),
+      queue_depth_(0),
+      max_queue_depth_(0),
+      total_wait_us_(0),
+      total_handler_us_(0),
+      max_handler_us_(0)
+{
+}
+
+DeviceEventDispatcher::~DeviceEventDispatcher() {
+    stop();
+}
+
+void DeviceEventDispatcher::set_worker_count(size_t worker_count) {
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    worker_count_ = std::max<size_t>(worker_count, 1);
+}
+
+void DeviceEventDispatcher::start() {
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    if (running_) {
+        return;
+    }
+
+    workers_.clear();
+    for (size_t i = 0; i < worker_count_; i++) {
+        workers_.push_back(std::make_unique<Worker>());
+        Worker* worker = workers_.back().get();
+        worker->thread = std::thread([this, worker]() { worker_loop(*worker); });
+    }
+    running_ = true;
+}
+
+void DeviceEventDispatcher::stop() {
+    std::lock_guard<std::mutex> lock(lifecycle_mutex_);
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+
+    for (auto& worker : workers_) {
+        {
+            std::lock_guard<std::mutex> worker_lock(worker->mutex);
+            worker->stopping = true;
+        }
+        worker->cv.notify_one();
+    }
+
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+bool DeviceEventDispatcher::post(const std::string& did, Event event) {
+    if (!running_) {
+        return false;
+    }
+
+    // Same DID always lands on the same worker, which keeps its events ordered
+    Worker& worker = *workers_[std::hash<std::string>{}(did) % workers_.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.stopping) {
+            return false;
+        }
+        worker.queue.push_back({std::move(event), std::chrono::steady_clock::now()});
+
+        // Counted before a worker can pop the event, so its decrement never comes first
+        posted_.fetch_add(1, std::memory_order_relaxed);
+        size_t depth = queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+        update_max(max_queue_depth_, depth);
+    }
+    worker.cv.notify_one();
+    return true;
+}
+
+DeviceEventStats DeviceEventDispatcher::get_stats() const {
+    DeviceEventStats stats;
+    stats.posted = posted_.load(std::memory_order_relaxed);
+    stats.dispatched = dispatched_.load(std::memory_order_relaxed);
+    stats.queue_depth = queue_depth_.load(std::memory_order_relaxed);
+    stats.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    stats.max_handler_us = max_handler_us_.load(std::memory_order_relaxed);
+    if (stats.dispatched > 0) {
+        stats.avg_wait_us = total_wait_us_.load(std::memory_order_relaxed) / stats.dispatched;
+        stats.avg_handler_us = total_handler_us_.load(std::memory_order_relaxed) / stats.dispatched;
+    }
+    return stats;
+}
+
+void DeviceEventDispatcher::worker_loop(Worker& worker) {
+    while (true) {
+        PendingEvent pending;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.cv.wait(lock, [&worker]() { return worker.stopping || !worker.queue.empty(); });
+            if (worker.queue.empty()) {
+                // Stopping and drained
+                return;
+            }
+            pending = std::move(worker.queue.front());
+            worker.queue.pop_front();
+        }
+        queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+
+        auto started_at = std::chrono::steady_clock::now();
+        try {
+            pending.event();
+        } catch (const std::exception& e) {
+            std::cerr << "[DeviceEventDispatcher] Event handler error: " << e.what() << std::endl;
+        }
+        auto finished_at = std::chrono::steady_clock::now();
+
+        uint64_t handler_us = elapsed_us(started_at, finished_at);
+        total_wait_us_.fetch_add(elapsed_us(pending.posted_at, started_at), std::memory_order_relaxed);
+        total_handler_us_.fetch_add(handler_us, std::memory_order_relaxed);
+        update_max(max_handler_us_, handler_us);
+        dispatched_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace miot
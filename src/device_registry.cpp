@@ -0,0 +1,239 @@
+/**
+ * Device Registry - Implementation
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "device_registry.h"
+
+#ifdef _WIN32
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+#endif
+
+namespace miot {
+
+namespace {
+
+const size_t INITIAL_SLOTS = 16;
+
+// Format an IPv4 address given in network byte order
+std::string ipv4_to_string(uint32_t addr) {
+    struct in_addr in;
+    in.s_addr = addr;
+    char ip[INET_ADDRSTRLEN] = {0};
+    inet_ntop(AF_INET, &in, ip, INET_ADDRSTRLEN);
+    return ip;
+}
+
+} // anonymous namespace
+
+DeviceRegistry::DeviceRegistry(size_t shard_count)
+    : size_(0),
+      version_(1),
+      snapshot_(std::make_shared<const DeviceSnapshot>()),
+      snapshot_version_(0)
+{
+    size_t count = 1;
+    while (count < shard_count) {
+        count <<= 1;
+    }
+    shard_mask_ = count - 1;
+
+    shards_.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        auto shard = std::make_unique<Shard>();
+        shard->slots.assign(INITIAL_SLOTS, Slot{0, EMPTY_SLOT});
+        shards_.push_back(std::move(shard));
+    }
+}
+
+uint64_t DeviceRegistry::hash(uint64_t did) {
+    // splitmix64 finalizer: DIDs are often sequential, spread them over all bits
+    did ^= did >> 30;
+    did *= 0xbf58476d1ce4e5b9ULL;
+    did ^= did >> 27;
+    did *= 0x94d049bb133111ebULL;
+    did ^= did >> 31;
+    return did;
+}
+
+DeviceRegistry::Shard& DeviceRegistry::shard_for(uint64_t hashed) const {
+    // High bits pick the shard, low bits the slot within it
+    return *shards_[(hashed >> 48) & shard_mask_];
+}
+
+DeviceRegistry::Entry* DeviceRegistry::find_entry(Shard& shard, uint64_t did, uint64_t hashed) {
+    size_t mask = shard.slots.size() - 1;
+    for (size_t i = hashed & mask; ; i = (i + 1) & mask) {
+        const Slot& slot = shard.slots[i];
+        if (slot.entry == EMPTY_SLOT) {
+            return nullptr;
+        }
+        if (slot.did == did) {
+            return &shard.entries[slot.entry];
+        }
+    }
+}
+
+void DeviceRegistry::insert_slot(std::vector<Slot>& slots, uint64_t did, uint64_t hashed, uint32_t entry) {
+    size_t mask = slots.size() - 1;
+    size_t i = hashed & mask;
+    while (slots[i].entry != EMPTY_SLOT) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = Slot{did, entry};
+}
+
+void DeviceRegistry::grow(Shard& shard) {
+    std::vector<Slot> slots(shard.slots.size() * 2, Slot{0, EMPTY_SLOT});
+    for (const Slot& slot : shard.slots) {
+        if (slot.entry != EMPTY_SLOT) {
+            insert_slot(slots, slot.did, hash(slot.did), slot.entry);
+        }
+    }
+    shard.slots.swap(slots);
+}
+
+bool DeviceRegistry::update(
+    uint64_t did,
+    uint32_t ip_addr,
+    const std::string& interface_name,
+    int64_t timestamp_offset,
+    std::chrono::steady_clock::time_point now,
+    DeviceInfo& changed
+) {
+    uint64_t hashed = hash(did);
+    Shard& shard = shard_for(hashed);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    Entry* entry = find_entry(shard, did, hashed);
+    if (!entry) {
+        // New device, the only place the DID is formatted
+        if ((shard.entries.size() + 1) * 4 > shard.slots.size() * 3) {
+            grow(shard);
+        }
+
+        Entry fresh;
+        fresh.ip_addr = ip_addr;
+        fresh.info.did = std::to_string(did);
+        fresh.info.ip = ipv4_to_string(ip_addr);
+        fresh.info.interface = interface_name;
+        fresh.info.online = true;
+        fresh.info.timestamp_offset = timestamp_offset;
+        fresh.info.last_seen = now;
+        fresh.info.status_changed_type = DeviceStatusChangedType::NEW;
+
+        insert_slot(shard.slots, did, hashed, static_cast<uint32_t>(shard.entries.size()));
+        shard.entries.push_back(std::move(fresh));
+        size_++;
+        version_++;
+
+        changed = shard.entries.back().info;
+        return true;
+    }
+
+    DeviceInfo& device = entry->info;
+    bool status_changed = false;
+
+    if (!device.online) {
+        device.online = true;
+        status_changed = true;
+        device.status_changed_type = DeviceStatusChangedType::ONLINE;
+    }
+
+    if (entry->ip_addr != ip_addr) {
+        entry->ip_addr = ip_addr;
+        device.ip = ipv4_to_string(ip_addr);
+        status_changed = true;
+        device.status_changed_type = DeviceStatusChangedType::IP_CHANGED;
+    }
+
+    if (device.interface != interface_name) {
+        device.interface = interface_name;
+        status_changed = true;
+        device.status_changed_type = DeviceStatusChangedType::INTERFACE_CHANGED;
+    }
+
+    device.timestamp_offset = timestamp_offset;
+    device.last_seen = now;
+
+    if (status_changed) {
+        version_++;
+        changed = device;
+    }
+    return status_changed;
+}
+
+bool DeviceRegistry::find(uint64_t did, DeviceInfo& info) const {
+    uint64_t hashed = hash(did);
+    Shard& shard = shard_for(hashed);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    Entry* entry = find_entry(shard, did, hashed);
+    if (!entry) {
+        return false;
+    }
+    info = entry->info;
+    return true;
+}
+
+bool DeviceRegistry::expire_if_idle(uint64_t did, std::chrono::steady_clock::time_point cutoff, DeviceInfo& info) {
+    uint64_t hashed = hash(did);
+    Shard& shard = shard_for(hashed);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    Entry* entry = find_entry(shard, did, hashed);
+    if (!entry) {
+        return false;
+    }
+
+    DeviceInfo& device = entry->info;
+    bool expired = device.online && device.last_seen <= cutoff;
+    if (expired) {
+        device.online = false;
+        device.status_changed_type = DeviceStatusChangedType::OFFLINE;
+        version_++;
+    }
+    info = device;
+    return expired;
+}
+
+std::shared_ptr<const DeviceSnapshot> DeviceRegistry::snapshot() const {
+    // Fast path: nothing changed since the last snapshot was published
+    uint64_t version = version_.load(std::memory_order_acquire);
+    if (snapshot_version_.load(std::memory_order_acquire) == version) {
+        return std::atomic_load(&snapshot_);
+    }
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    version = version_.load(std::memory_order_acquire);
+    if (snapshot_version_.load(std::memory_order_relaxed) == version) {
+        return std::atomic_load(&snapshot_);
+    }
+
+    auto published = std::make_shared<const DeviceSnapshot>(collect());
+    std::atomic_store(&snapshot_, published);
+    snapshot_version_.store(version, std::memory_order_release);
+    return published;
+}
+
+DeviceSnapshot DeviceRegistry::collect() const {
+    DeviceSnapshot devices;
+    devices.reserve(size_.load());
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (const Entry& entry : shard->entries) {
+            devices.push_back(entry.info);
+        }
+    }
+    return devices;
+}
+
+size_t DeviceRegistry::size() const {
+    return size_.load();
+}
+
+} // namespace miot
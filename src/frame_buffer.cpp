@@ -0,0 +1,159 @@
+/**
+ * Frame Buffer - Implementation
+ * 
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "frame_buffer.h"
+
+#include <cstring>
+
+namespace miot {
+
+constexpr size_t FrameBufferPool::SIZE_CLASSES[FrameBufferPool::NUM_SIZE_CLASSES];
+
+FrameBuffer::FrameBuffer(size_t capacity)
+    : storage_(new uint8_t[capacity]),
+      capacity_(capacity),
+      size_(0)
+{
+}
+
+void FrameBuffer::assign(const uint8_t* src, size_t len) {
+    if (len > capacity_) {
+        len = capacity_;
+    }
+    std::memcpy(storage_.get(), src, len);
+    size_ = len;
+}
+
+std::shared_ptr<FrameBufferPool> FrameBufferPool::create(const FrameBufferPoolConfig& config) {
+    return std::shared_ptr<FrameBufferPool>(new FrameBufferPool(config));
+}
+
+FrameBufferPool::FrameBufferPool(const FrameBufferPoolConfig& config)
+    : config_(config)
+{
+}
+
+FrameBufferPool::~FrameBufferPool() {
+    for (auto& list : free_) {
+        for (FrameBuffer* buffer : list) {
+            delete buffer;
+        }
+    }
+}
+
+size_t FrameBufferPool::size_class_for(size_t size) {
+    for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        if (size <= SIZE_CLASSES[i]) {
+            return i;
+        }
+    }
+    return NUM_SIZE_CLASSES;
+}
+
+bool FrameBufferPool::reserve_bytes(size_t bytes) {
+    // Caller holds mutex_. Give idle memory back before refusing.
+    for (size_t i = NUM_SIZE_CLASSES; i-- > 0 && stats_.bytes_total + bytes > config_.max_total_bytes;) {
+        while (!free_[i].empty() && stats_.bytes_total + bytes > config_.max_total_bytes) {
+            stats_.bytes_total -= free_[i].back()->capacity();
+            delete free_[i].back();
+            free_[i].pop_back();
+        }
+    }
+    
+    if (stats_.bytes_total + bytes > config_.max_total_bytes) {
+        return false;
+    }
+    stats_.bytes_total += bytes;
+    return true;
+}
+
+FrameBufferPtr FrameBufferPool::acquire(size_t size) {
+    size_t size_class = size_class_for(size);
+    size_t capacity = size_class < NUM_SIZE_CLASSES ? SIZE_CLASSES[size_class] : size;
+    FrameBuffer* buffer = nullptr;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        if (size_class < NUM_SIZE_CLASSES && !free_[size_class].empty()) {
+            buffer = free_[size_class].back();
+            free_[size_class].pop_back();
+            stats_.hits++;
+        } else {
+            if (!reserve_bytes(capacity)) {
+                stats_.rejected++;
+                return nullptr;
+            }
+            stats_.misses++;
+            if (size_class == NUM_SIZE_CLASSES) {
+                stats_.oversize++;
+            }
+        }
+        
+        stats_.bytes_in_use += capacity;
+        if (stats_.bytes_in_use > stats_.high_water_bytes) {
+            stats_.high_water_bytes = stats_.bytes_in_use;
+        }
+    }
+    
+    if (!buffer) {
+        buffer = new FrameBuffer(capacity);
+    }
+    buffer->size_ = 0;
+    
+    std::weak_ptr<FrameBufferPool> pool = shared_from_this();
+    return FrameBufferPtr(buffer, [pool](FrameBuffer* b) { recycle(pool, b); });
+}
+
+FrameBufferPtr FrameBufferPool::copy_from(const uint8_t* src, size_t len) {
+    FrameBufferPtr buffer = acquire(len);
+    if (buffer) {
+        buffer->assign(src, len);
+    }
+    return buffer;
+}
+
+size_t FrameBufferPool::free_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& list : free_) {
+        count += list.size();
+    }
+    return count;
+}
+
+FrameBufferPoolStats FrameBufferPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void FrameBufferPool::recycle(const std::weak_ptr<FrameBufferPool>& pool, FrameBuffer* buffer) {
+    if (auto owner = pool.lock()) {
+        owner->release(buffer);
+    } else {
+        delete buffer;
+    }
+}
+
+void FrameBufferPool::release(FrameBuffer* buffer) {
+    size_t capacity = buffer->capacity();
+    size_t size_class = size_class_for(capacity);
+    bool pooled = size_class < NUM_SIZE_CLASSES && SIZE_CLASSES[size_class] == capacity;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.bytes_in_use -= capacity;
+        if (pooled && free_[size_class].size() < config_.max_free_per_class) {
+            free_[size_class].push_back(buffer);
+            return;
+        }
+        stats_.bytes_total -= capacity;
+    }
+    delete buffer;
+}
+
+} // namespace miot
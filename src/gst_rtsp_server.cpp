@@ -1,11 +1,105 @@
 #include "gst_rtsp_server.h"
 #include <iostream>
 #include <sstream>
+#include <cctype>
 
 namespace miot {
 
-GstRtspServer::GstRtspServer(int port, const std::string& mount_point)
-    : port_(port), mount_point_(mount_point) {
+namespace {
+
+/**
+ * 编码特性：appsrc caps、可选的 parse 元素、payloader 和 payload type。
+ * 每种编码在编译期特化，热路径只比较 CameraCodec，不做字符串匹配。
+ */
+template <CameraCodec Codec>
+struct CodecTraits;
+
+template <>
+struct CodecTraits<CameraCodec::VIDEO_H264> {
+    static constexpr const char* caps = "video/x-h264,stream-format=byte-stream,alignment=au";
+    static constexpr const char* parse = "h264parse";
+    static constexpr const char* payloader = "rtph264pay config-interval=1";
+    static constexpr int payload_type = 96;
+};
+
+template <>
+struct CodecTraits<CameraCodec::VIDEO_H265> {
+    static constexpr const char* caps = "video/x-h265,stream-format=byte-stream,alignment=au";
+    static constexpr const char* parse = "h265parse";
+    static constexpr const char* payloader = "rtph265pay config-interval=1";
+    static constexpr int payload_type = 96;
+};
+
+template <>
+struct CodecTraits<CameraCodec::AUDIO_PCM> {
+    // rtpL16pay 需要大端，摄像头输出小端 PCM
+    static constexpr const char* caps = "audio/x-raw,format=S16LE,layout=interleaved,rate=8000,channels=1";
+    static constexpr const char* parse = "audioconvert";
+    static constexpr const char* payloader = "rtpL16pay";
+    static constexpr int payload_type = 97;
+};
+
+template <>
+struct CodecTraits<CameraCodec::AUDIO_G711U> {
+    static constexpr const char* caps = "audio/x-mulaw,rate=8000,channels=1";
+    static constexpr const char* parse = nullptr;
+    static constexpr const char* payloader = "rtppcmupay";
+    static constexpr int payload_type = 0;
+};
+
+template <>
+struct CodecTraits<CameraCodec::AUDIO_G711A> {
+    static constexpr const char* caps = "audio/x-alaw,rate=8000,channels=1";
+    static constexpr const char* parse = nullptr;
+    static constexpr const char* payloader = "rtppcmapay";
+    static constexpr int payload_type = 8;
+};
+
+template <>
+struct CodecTraits<CameraCodec::AUDIO_OPUS> {
+    static constexpr const char* caps = "audio/x-opus,channel-mapping-family=0";
+    static constexpr const char* parse = "opusparse";
+    static constexpr const char* payloader = "rtpopuspay";
+    static constexpr int payload_type = 97;
+};
+
+} // anonymous namespace
+
+struct GstRtspServer::CodecPipeline {
+    CameraCodec codec;
+    const char* name;
+    const char* caps;
+    const char* parse;
+    const char* payloader;
+    int payload_type;
+};
+
+template <CameraCodec Codec>
+constexpr GstRtspServer::CodecPipeline GstRtspServer::make_codec_pipeline(const char* name) {
+    return {Codec, name, CodecTraits<Codec>::caps, CodecTraits<Codec>::parse,
+            CodecTraits<Codec>::payloader, CodecTraits<Codec>::payload_type};
+}
+
+const GstRtspServer::CodecPipeline* GstRtspServer::find_codec_pipeline(CameraCodec codec) {
+    static constexpr CodecPipeline pipelines[] = {
+        make_codec_pipeline<CameraCodec::VIDEO_H264>("H264"),
+        make_codec_pipeline<CameraCodec::VIDEO_H265>("H265"),
+        make_codec_pipeline<CameraCodec::AUDIO_PCM>("PCM"),
+        make_codec_pipeline<CameraCodec::AUDIO_G711U>("G711U"),
+        make_codec_pipeline<CameraCodec::AUDIO_G711A>("G711A"),
+        make_codec_pipeline<CameraCodec::AUDIO_OPUS>("OPUS"),
+    };
+    
+    for (const auto& pipeline : pipelines) {
+        if (pipeline.codec == codec) {
+            return &pipeline;
+        }
+    }
+    return nullptr;
+}
+
+GstRtspServer::GstRtspServer(int port)
+    : port_(port) {
 }
 
 GstRtspServer::~GstRtspServer() {
@@ -28,37 +122,6 @@ bool GstRtspServer::init() {
     gst_rtsp_server_set_service(server_, port_str);
     g_free(port_str);
     
-    // 创建 media factory
-    GstRTSPMediaFactory* factory = gst_rtsp_media_factory_new();
-    
-    // 支持音视频的 RTSP pipeline
-    // 视频: H265 
-    // 音频: G711A (PCMA)
-    const char* launch_str = 
-        "( "
-        // 视频流
-        "appsrc name=videosrc is-live=true format=time "
-        "  caps=video/x-h265,stream-format=byte-stream,alignment=au "
-        "! h265parse "
-        "! rtph265pay name=pay0 pt=96 config-interval=1 "
-        // 音频流 (G711A/PCMA)
-        "appsrc name=audiosrc is-live=true format=time "
-        "  caps=audio/x-alaw,rate=8000,channels=1 "
-        "! rtppcmapay name=pay1 pt=8 "
-        ")";
-    
-    gst_rtsp_media_factory_set_launch(factory, launch_str);
-    gst_rtsp_media_factory_set_shared(factory, TRUE);  // 允许多客户端
-    
-    // 连接 media-configure 信号
-    g_signal_connect(factory, "media-configure", 
-                     G_CALLBACK(media_configure_callback), this);
-    
-    // 获取 mount points 并添加 factory
-    GstRTSPMountPoints* mounts = gst_rtsp_server_get_mount_points(server_);
-    gst_rtsp_mount_points_add_factory(mounts, mount_point_.c_str(), factory);
-    g_object_unref(mounts);
-    
     std::cout << "RTSP Server (Audio+Video) initialized on port " << port_ << std::endl;
     return true;
 }
@@ -107,36 +170,463 @@ void GstRtspServer::stop() {
         loop_ = nullptr;
     }
     
+    std::map<std::string, MountPtr> mounts;
+    {
+        std::lock_guard<std::mutex> lock(mounts_mutex_);
+        mounts.swap(mounts_);
+    }
+    for (auto& pair : mounts) {
+        std::lock_guard<std::mutex> lock(pair.second->state_mutex);
+        pair.second->removed = true;
+        cancel_idle(*pair.second);
+        release_appsrcs(*pair.second);
+    }
+    
     if (server_) {
         g_object_unref(server_);
         server_ = nullptr;
     }
 }
 
-void GstRtspServer::push_video_frame(const std::vector<uint8_t>& data, 
-                                uint64_t timestamp, 
-                                bool is_keyframe) {
-    if (!running_ || !video_appsrc_) {
-        // 如果还没有客户端连接，暂存帧（可选）
+bool GstRtspServer::add_mount(const std::string& mount_point) {
+    if (!server_) {
+        std::cerr << "RTSP server not initialized" << std::endl;
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(mounts_mutex_);
+    if (mounts_.count(mount_point)) {
+        return true;
+    }
+    
+    auto mount = std::make_shared<Mount>();
+    mount->path = mount_point;
+    mount->server = this;
+    mounts_[mount_point] = mount;
+    
+    std::cout << "RTSP mount added: " << get_url(mount_point) 
+              << " (waiting for first frame to select codec)" << std::endl;
+    return true;
+}
+
+void GstRtspServer::on_video_codec(const MountPtr& mount, CameraCodec codec) {
+    if (mount->has_rejected_video_codec && mount->rejected_video_codec == codec) {
+        return;
+    }
+    
+    const CodecPipeline* pipeline = find_codec_pipeline(codec);
+    if (!pipeline || (codec != CameraCodec::VIDEO_H264 && codec != CameraCodec::VIDEO_H265)) {
+        std::cerr << "[" << mount->path << "] Unsupported video codec: " 
+                  << static_cast<int>(codec) << std::endl;
+        mount->rejected_video_codec = codec;
+        mount->has_rejected_video_codec = true;
+        return;
+    }
+    
+    if (mount->has_video_codec) {
+        std::cout << "[" << mount->path << "] Video codec changed, rebuilding pipeline" << std::endl;
+        clear_gop_cache(*mount);
+        restart_media(mount);
+    }
+    mount->video_codec = codec;
+    mount->has_video_codec = true;
+    mount->video_pipeline = pipeline;
+    update_factory(mount);
+}
+
+void GstRtspServer::on_audio_codec(const MountPtr& mount, CameraCodec codec) {
+    if (mount->has_rejected_audio_codec && mount->rejected_audio_codec == codec) {
+        return;
+    }
+    
+    const CodecPipeline* pipeline = find_codec_pipeline(codec);
+    if (!pipeline || codec == CameraCodec::VIDEO_H264 || codec == CameraCodec::VIDEO_H265) {
+        std::cerr << "[" << mount->path << "] Unsupported audio codec: " 
+                  << static_cast<int>(codec) << std::endl;
+        mount->rejected_audio_codec = codec;
+        mount->has_rejected_audio_codec = true;
+        return;
+    }
+    
+    if (mount->has_audio_codec) {
+        std::cout << "[" << mount->path << "] Audio codec changed, rebuilding pipeline" << std::endl;
+        restart_media(mount);
+    }
+    mount->audio_codec = codec;
+    mount->has_audio_codec = true;
+    mount->audio_pipeline = pipeline;
+    
+    // 音频先于视频到达时只记录，等视频编码确定后一起创建
+    if (mount->video_pipeline) {
+        update_factory(mount);
+    }
+}
+
+std::string GstRtspServer::build_launch(const Mount& mount) {
+    std::stringstream launch;
+    launch << "( ";
+    
+    if (mount.video_pipeline) {
+        const CodecPipeline& video = *mount.video_pipeline;
+        launch << "appsrc name=videosrc is-live=true format=time caps=" << video.caps << " ";
+        if (video.parse) {
+            launch << "! " << video.parse << " ";
+        }
+        launch << "! " << video.payloader << " name=pay0 pt=" << video.payload_type << " ";
+    }
+    
+    if (mount.audio_pipeline) {
+        const CodecPipeline& audio = *mount.audio_pipeline;
+        launch << "appsrc name=audiosrc is-live=true format=time caps=" << audio.caps << " ";
+        if (audio.parse) {
+            launch << "! " << audio.parse << " ";
+        }
+        launch << "! " << audio.payloader << " name=pay1 pt=" << audio.payload_type << " ";
+    }
+    
+    launch << ")";
+    return launch.str();
+}
+
+void GstRtspServer::update_factory(const MountPtr& mount) {
+    std::string launch = build_launch(*mount);
+    
+    if (mount->factory) {
+        // 已挂载：新的 launch 对下一个 media 生效，当前客户端不受影响
+        gst_rtsp_media_factory_set_launch(mount->factory, launch.c_str());
+    } else {
+        // 创建 media factory
+        GstRTSPMediaFactory* factory = gst_rtsp_media_factory_new();
+        gst_rtsp_media_factory_set_launch(factory, launch.c_str());
+        gst_rtsp_media_factory_set_shared(factory, TRUE);  // 允许多客户端
+        
+        // 连接 media-configure 信号
+        g_signal_connect_data(factory, "media-configure", 
+                              G_CALLBACK(media_configure_callback), ref_mount(mount),
+                              unref_mount, static_cast<GConnectFlags>(0));
+        mount->factory = factory;
+        
+        // 获取 mount points 并添加 factory（mount points 接管 factory 引用）
+        GstRTSPMountPoints* mount_points = gst_rtsp_server_get_mount_points(server_);
+        gst_rtsp_mount_points_add_factory(mount_points, mount->path.c_str(), factory);
+        g_object_unref(mount_points);
+        
+        // 首次对外提供时还没有客户端，超过 idle linger 无人连接同样视为空闲
+        schedule_idle(mount);
+    }
+    
+    std::cout << "[" << mount->path << "] RTSP pipeline: video=" 
+              << (mount->video_pipeline ? mount->video_pipeline->name : "none")
+              << ", audio=" << (mount->audio_pipeline ? mount->audio_pipeline->name : "none") 
+              << std::endl;
+}
+
+void GstRtspServer::restart_media(const MountPtr& mount) {
+    // 共享 media 的 appsrc caps 和 parse 元素按旧编码创建，只改 launch 影响不到它：
+    // 撤下旧 factory 让 update_factory 挂一个新的，并 unprepare 当前 media，客户端重连到新 pipeline
+    if (!mount->factory) {
+        return;
+    }
+    
+    GstRTSPMountPoints* mount_points = gst_rtsp_server_get_mount_points(server_);
+    gst_rtsp_mount_points_remove_factory(mount_points, mount->path.c_str());
+    g_object_unref(mount_points);
+    mount->factory = nullptr;
+    
+    if (mount->media) {
+        // unprepare 会同步触发 media_unprepared_callback，此处持有 state_mutex，交给 GMainLoop 执行
+        g_idle_add_full(G_PRIORITY_DEFAULT, unprepare_media_callback,
+                        g_object_ref(mount->media), g_object_unref);
+    }
+    
+    mount->gop_replay_pending = false;
+    mount->first_video_frame = true;
+    mount->first_audio_frame = true;
+    mount->video_base_timestamp = 0;
+    mount->audio_base_timestamp = 0;
+    release_appsrcs(*mount);
+}
+
+void GstRtspServer::remove_mount(const std::string& mount_point) {
+    MountPtr mount;
+    {
+        std::lock_guard<std::mutex> lock(mounts_mutex_);
+        auto it = mounts_.find(mount_point);
+        if (it == mounts_.end()) {
+            return;
+        }
+        mount = it->second;
+        mounts_.erase(it);
+    }
+    
+    std::lock_guard<std::mutex> lock(mount->state_mutex);
+    mount->removed = true;
+    cancel_idle(*mount);
+    
+    if (server_ && mount->factory) {
+        GstRTSPMountPoints* mount_points = gst_rtsp_server_get_mount_points(server_);
+        gst_rtsp_mount_points_remove_factory(mount_points, mount_point.c_str());
+        g_object_unref(mount_points);
+        mount->factory = nullptr;
+    }
+    
+    // 通知已连接的客户端流结束
+    GstFlowReturn ret;
+    if (mount->video_appsrc) {
+        g_signal_emit_by_name(mount->video_appsrc, "end-of-stream", &ret);
+    }
+    if (mount->audio_appsrc) {
+        g_signal_emit_by_name(mount->audio_appsrc, "end-of-stream", &ret);
+    }
+    release_appsrcs(*mount);
+    clear_gop_cache(*mount);
+    
+    std::cout << "RTSP mount removed: " << mount_point << std::endl;
+}
+
+void GstRtspServer::set_client_presence_callback(ClientPresenceCallback callback,
+                                                 std::chrono::milliseconds idle_linger) {
+    presence_callback_ = std::move(callback);
+    idle_linger_ = idle_linger;
+}
+
+void GstRtspServer::reset_mount(const std::string& mount_point) {
+    MountPtr mount = find_mount(mount_point);
+    if (!mount) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mount->state_mutex);
+    clear_gop_cache(*mount);
+}
+
+bool GstRtspServer::has_mount(const std::string& mount_point) const {
+    return find_mount(mount_point) != nullptr;
+}
+
+GstRtspServer::MountPtr GstRtspServer::find_mount(const std::string& mount_point) const {
+    std::lock_guard<std::mutex> lock(mounts_mutex_);
+    auto it = mounts_.find(mount_point);
+    return it != mounts_.end() ? it->second : nullptr;
+}
+
+std::string GstRtspServer::make_mount_point(const std::string& name) {
+    std::string path = "/";
+    bool has_alnum = false;
+    for (unsigned char c : name) {
+        if (std::isalnum(c)) {
+            path += static_cast<char>(std::tolower(c));
+            has_alnum = true;
+        } else if (c == '-' || c == '_') {
+            path += static_cast<char>(c);
+        } else if (path.back() != '_') {
+            // 空格、标点和非 ASCII 字符统一替换为 '_'
+            path += '_';
+        }
+    }
+    
+    while (path.size() > 1 && path.back() == '_') {
+        path.pop_back();
+    }
+    return has_alnum ? path : "";
+}
+
+gpointer GstRtspServer::ref_mount(const MountPtr& mount) {
+    return new MountPtr(mount);
+}
+
+void GstRtspServer::unref_mount(gpointer data, GClosure* closure) {
+    (void)closure;
+    delete static_cast<MountPtr*>(data);
+}
+
+void GstRtspServer::unref_mount_source(gpointer data) {
+    delete static_cast<MountPtr*>(data);
+}
+
+void GstRtspServer::schedule_idle(const MountPtr& mount) {
+    if (!presence_callback_) {
         return;
     }
+    
+    cancel_idle(*mount);
+    mount->idle_source = g_timeout_add_full(G_PRIORITY_DEFAULT,
+                                            static_cast<guint>(idle_linger_.count()),
+                                            idle_timeout_callback,
+                                            ref_mount(mount),
+                                            unref_mount_source);
+}
+
+void GstRtspServer::cancel_idle(Mount& mount) {
+    if (mount.idle_source) {
+        g_source_remove(mount.idle_source);
+        mount.idle_source = 0;
+    }
+}
+
+gboolean GstRtspServer::idle_timeout_callback(gpointer user_data) {
+    MountPtr mount = *static_cast<MountPtr*>(user_data);
+    
+    {
+        std::lock_guard<std::mutex> lock(mount->state_mutex);
+        // 等锁期间可能已被取消或重新计时
+        if (mount->idle_source != g_source_get_id(g_main_current_source())) {
+            return G_SOURCE_REMOVE;
+        }
+        mount->idle_source = 0;
+        
+        if (mount->removed || mount->media) {
+            return G_SOURCE_REMOVE;
+        }
+    }
+    
+    std::cout << "[" << mount->path << "] No RTSP clients for " 
+              << mount->server->idle_linger_.count() << " ms, mount idle" << std::endl;
+    
+    // 不持锁回调，回调内可以停止摄像头、调用 reset_mount
+    mount->server->presence_callback_(mount->path, false);
+    return G_SOURCE_REMOVE;
+}
+
+void GstRtspServer::clear_gop_cache(Mount& mount) {
+    mount.gop_cache.clear();
+    mount.gop_cache_bytes = 0;
+}
+
+void GstRtspServer::release_appsrcs(Mount& mount) {
+    mount.media = nullptr;
+    
+    if (mount.video_appsrc) {
+        g_object_unref(mount.video_appsrc);
+        mount.video_appsrc = nullptr;
+    }
+    
+    if (mount.audio_appsrc) {
+        g_object_unref(mount.audio_appsrc);
+        mount.audio_appsrc = nullptr;
+    }
+}
 
-    if (first_video_frame_) {
-        video_base_timestamp_ = timestamp;
-        first_video_frame_ = false;
-        std::cout << "First video frame timestamp (base): " << video_base_timestamp_ << std::endl;
+GstBuffer* GstRtspServer::wrap_frame_buffer(const FrameBufferPtr& frame) {
+    // GstBuffer 持有一份 FrameBufferPtr，payloader 用完后由 notify 释放回池
+    auto* ref = new FrameBufferPtr(frame);
+    return gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY,
+                                       frame->data(),
+                                       frame->capacity(),
+                                       0,
+                                       frame->size(),
+                                       ref,
+                                       release_frame_buffer);
+}
+
+void GstRtspServer::release_frame_buffer(gpointer user_data) {
+    delete static_cast<FrameBufferPtr*>(user_data);
+}
+
+void GstRtspServer::push_video_frame(const std::string& mount_point,
+                                     CameraCodec codec,
+                                     const FrameBufferPtr& frame, 
+                                     uint64_t timestamp, 
+                                     bool is_keyframe) {
+    if (!running_ || !frame) {
+        return;
     }
     
-    // 创建 GstBuffer
-    GstBuffer* buffer = gst_buffer_new_allocate(nullptr, data.size(), nullptr);
+    MountPtr mount = find_mount(mount_point);
+    if (!mount) {
+        return;
+    }
     
-    GstMapInfo map;
-    gst_buffer_map(buffer, &map, GST_MAP_WRITE);
-    memcpy(map.data, data.data(), data.size());
-    gst_buffer_unmap(buffer, &map);
+    std::lock_guard<std::mutex> lock(mount->state_mutex);
+    if (mount->removed) {
+        return;
+    }
+    
+    // 根据实际编码创建/更新 pipeline
+    if (!mount->has_video_codec || mount->video_codec != codec) {
+        on_video_codec(mount, codec);
+        if (!mount->video_pipeline || mount->video_codec != codec) {
+            return;
+        }
+    }
+    
+    // 即使没有客户端也缓存，新客户端可以立即拿到完整 GOP
+    cache_video_frame(*mount, frame, timestamp, is_keyframe);
+    
+    // 没有客户端，或者等待 GOP 回放（回放会包含这一帧）
+    if (!mount->video_appsrc || mount->gop_replay_pending) {
+        return;
+    }
+    
+    push_video_buffer(*mount, frame, timestamp, is_keyframe, false);
+}
+
+void GstRtspServer::cache_video_frame(Mount& mount,
+                                      const FrameBufferPtr& frame, 
+                                      uint64_t timestamp, 
+                                      bool is_keyframe) {
+    if (is_keyframe) {
+        // 参数集 (VPS/SPS/PPS) 和 IDR 可能分开到达，连续的关键帧属于同一个 GOP 起点
+        if (!mount.gop_cache.empty() && !mount.gop_cache.back().is_keyframe) {
+            clear_gop_cache(mount);
+        }
+    } else if (mount.gop_cache.empty()) {
+        // 没有 IDR 的 P 帧无法解码
+        return;
+    }
+    
+    if (mount.gop_cache.size() >= GOP_CACHE_MAX_FRAMES ||
+        mount.gop_cache_bytes + frame->capacity() > GOP_CACHE_MAX_BYTES) {
+        // GOP 过长，放弃缓存直到下一个关键帧
+        clear_gop_cache(mount);
+        return;
+    }
+    
+    mount.gop_cache.push_back({frame, timestamp, is_keyframe});
+    mount.gop_cache_bytes += frame->capacity();
+}
+
+void GstRtspServer::replay_gop_cache(Mount& mount) {
+    mount.gop_replay_pending = false;
+    
+    if (mount.gop_cache.empty()) {
+        return;
+    }
+    
+    // 以 GOP 起点作为时间基准，后续实时帧在此基础上连续；
+    // 音频共用同一起点，否则会比回放的视频超前整个 GOP 的时长
+    mount.video_base_timestamp = mount.gop_cache.front().timestamp;
+    mount.first_video_frame = false;
+    mount.audio_base_timestamp = mount.video_base_timestamp;
+    mount.first_audio_frame = false;
+    
+    bool discont = true;
+    for (const auto& cached : mount.gop_cache) {
+        push_video_buffer(mount, cached.buffer, cached.timestamp, cached.is_keyframe, discont);
+        discont = false;
+    }
+    
+    std::cout << "[" << mount.path << "] Replayed GOP cache: " << mount.gop_cache.size() 
+              << " frames" << std::endl;
+}
+
+void GstRtspServer::push_video_buffer(Mount& mount,
+                                      const FrameBufferPtr& frame, 
+                                      uint64_t timestamp, 
+                                      bool is_keyframe,
+                                      bool discont) {
+    if (mount.first_video_frame) {
+        mount.video_base_timestamp = timestamp;
+        mount.first_video_frame = false;
+        std::cout << "[" << mount.path << "] First video frame timestamp (base): " 
+                  << mount.video_base_timestamp << std::endl;
+    }
+    
+    // 创建 GstBuffer（直接引用帧数据，不拷贝）
+    GstBuffer* buffer = wrap_frame_buffer(frame);
     
     // 设置相对时间戳 (转换为纳秒)
-    GST_BUFFER_PTS(buffer) = (timestamp - video_base_timestamp_) * GST_MSECOND;
+    GST_BUFFER_PTS(buffer) = (timestamp - mount.video_base_timestamp) * GST_MSECOND;
     GST_BUFFER_DTS(buffer) = GST_BUFFER_PTS(buffer);
     GST_BUFFER_DURATION(buffer) = GST_CLOCK_TIME_NONE;
     
@@ -144,133 +634,200 @@ void GstRtspServer::push_video_frame(const std::vector<uint8_t>& data,
     if (!is_keyframe) {
         GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
     }
+    if (discont) {
+        GST_BUFFER_FLAG_SET(buffer, GST_BUFFER_FLAG_DISCONT);
+    }
     
     // 推送到 appsrc
     GstFlowReturn ret;
-    g_signal_emit_by_name(video_appsrc_, "push-buffer", buffer, &ret);
+    g_signal_emit_by_name(mount.video_appsrc, "push-buffer", buffer, &ret);
     gst_buffer_unref(buffer);
     
     if (ret != GST_FLOW_OK) {
         if (ret == GST_FLOW_FLUSHING) {
-            std::cout << "Video: Client disconnected (flushing)" << std::endl;
+            std::cout << "[" << mount.path << "] Video: Client disconnected (flushing)" << std::endl;
         } else {
-            std::cerr << "Failed to push video buffer: " << ret << std::endl;
+            std::cerr << "[" << mount.path << "] Failed to push video buffer: " << ret << std::endl;
         }
     }
 }
 
-void GstRtspServer::push_audio_frame(const std::vector<uint8_t>& data, 
-                                      uint64_t timestamp) {
-    if (!running_ || !audio_appsrc_) {
+void GstRtspServer::push_audio_frame(const std::string& mount_point,
+                                     CameraCodec codec,
+                                     const FrameBufferPtr& frame, 
+                                     uint64_t timestamp) {
+    if (!running_ || !frame) {
+        return;
+    }
+    
+    MountPtr mount = find_mount(mount_point);
+    if (!mount) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mount->state_mutex);
+    if (mount->removed) {
+        return;
+    }
+    
+    if (!mount->has_audio_codec || mount->audio_codec != codec) {
+        on_audio_codec(mount, codec);
+    }
+    
+    if (!mount->audio_appsrc) {
         // 如果还没有客户端连接或音频未启用
         return;
     }
 
-    if (first_audio_frame_) {
-        audio_base_timestamp_ = timestamp;
-        first_audio_frame_ = false;
-        std::cout << "First audio frame timestamp (base): " << audio_base_timestamp_ << std::endl;
+    if (mount->first_audio_frame) {
+        mount->audio_base_timestamp = timestamp;
+        mount->first_audio_frame = false;
+        std::cout << "[" << mount->path << "] First audio frame timestamp (base): " 
+                  << mount->audio_base_timestamp << std::endl;
     }
     
-    // 创建 GstBuffer
-    GstBuffer* buffer = gst_buffer_new_allocate(nullptr, data.size(), nullptr);
+    // 早于时间基准的音频（早于回放的 GOP）没有对应的视频，直接丢弃
+    if (timestamp < mount->audio_base_timestamp) {
+        return;
+    }
     
-    GstMapInfo map;
-    gst_buffer_map(buffer, &map, GST_MAP_WRITE);
-    memcpy(map.data, data.data(), data.size());
-    gst_buffer_unmap(buffer, &map);
+    // 创建 GstBuffer（直接引用帧数据，不拷贝）
+    GstBuffer* buffer = wrap_frame_buffer(frame);
     
     // 设置相对时间戳 (转换为纳秒)
-    GST_BUFFER_PTS(buffer) = (timestamp - audio_base_timestamp_) * GST_MSECOND;
+    GST_BUFFER_PTS(buffer) = (timestamp - mount->audio_base_timestamp) * GST_MSECOND;
     GST_BUFFER_DTS(buffer) = GST_BUFFER_PTS(buffer);
     GST_BUFFER_DURATION(buffer) = GST_CLOCK_TIME_NONE;
     
     // 推送到 appsrc
     GstFlowReturn ret;
-    g_signal_emit_by_name(audio_appsrc_, "push-buffer", buffer, &ret);
+    g_signal_emit_by_name(mount->audio_appsrc, "push-buffer", buffer, &ret);
     gst_buffer_unref(buffer);
     
     if (ret != GST_FLOW_OK) {
         if (ret == GST_FLOW_FLUSHING) {
-            std::cout << "Audio: Client disconnected (flushing)" << std::endl;
+            std::cout << "[" << mount->path << "] Audio: Client disconnected (flushing)" << std::endl;
         } else {
-            std::cerr << "Failed to push audio buffer: " << ret << std::endl;
+            std::cerr << "[" << mount->path << "] Failed to push audio buffer: " << ret << std::endl;
         }
     }
 }
 
-std::string GstRtspServer::get_url() const {
+std::string GstRtspServer::get_url(const std::string& mount_point) const {
     std::stringstream ss;
-    ss << "rtsp://0.0.0.0:" << port_ << mount_point_;
+    ss << "rtsp://0.0.0.0:" << port_ << mount_point;
     return ss.str();
 }
 
 void GstRtspServer::media_configure_callback(GstRTSPMediaFactory* factory,
                                               GstRTSPMedia* media,
                                               gpointer user_data) {
-    GstRtspServer* self = static_cast<GstRtspServer*>(user_data);
+    (void)factory;
+    MountPtr mount = *static_cast<MountPtr*>(user_data);
     
     GstElement* element = gst_rtsp_media_get_element(media);
     
+    std::unique_lock<std::mutex> lock(mount->state_mutex);
+    if (mount->removed) {
+        g_object_unref(element);
+        return;
+    }
+    
+    // 有客户端了，取消空闲计时
+    cancel_idle(*mount);
+    
+    // 共享 media 重新创建时，先释放上一次的 appsrc
+    release_appsrcs(*mount);
+    mount->media = media;
+    
     // 获取视频 appsrc
-    self->video_appsrc_ = gst_bin_get_by_name_recurse_up(GST_BIN(element), "videosrc");
+    mount->video_appsrc = gst_bin_get_by_name_recurse_up(GST_BIN(element), "videosrc");
     
-    if (self->video_appsrc_) {
+    if (mount->video_appsrc) {
         // 配置视频 appsrc
-        g_object_set(self->video_appsrc_,
+        g_object_set(mount->video_appsrc,
                      "stream-type", 0,  // GST_APP_STREAM_TYPE_STREAM
                      "format", GST_FORMAT_TIME,
                      "is-live", TRUE,
                      nullptr);
         
-        std::cout << "RTSP client connected, video appsrc configured" << std::endl;
+        // appsrc 启动后（首次 need-data）回放 GOP 缓存，之前推送会被 flush 掉
+        mount->gop_replay_pending = true;
+        g_signal_connect_data(mount->video_appsrc, "need-data", G_CALLBACK(need_data_callback),
+                              ref_mount(mount), unref_mount, static_cast<GConnectFlags>(0));
+        
+        std::cout << "[" << mount->path << "] RTSP client connected, video appsrc configured" << std::endl;
     }
     
     // 获取音频 appsrc
-    self->audio_appsrc_ = gst_bin_get_by_name_recurse_up(GST_BIN(element), "audiosrc");
+    mount->audio_appsrc = gst_bin_get_by_name_recurse_up(GST_BIN(element), "audiosrc");
     
-    if (self->audio_appsrc_) {
+    if (mount->audio_appsrc) {
         // 配置音频 appsrc
-        g_object_set(self->audio_appsrc_,
+        g_object_set(mount->audio_appsrc,
                      "stream-type", 0,  // GST_APP_STREAM_TYPE_STREAM
                      "format", GST_FORMAT_TIME,
                      "is-live", TRUE,
                      nullptr);
         
-        std::cout << "RTSP client connected, audio appsrc configured" << std::endl;
+        std::cout << "[" << mount->path << "] RTSP client connected, audio appsrc configured" << std::endl;
     }
     
-    g_signal_connect(media, "unprepared", G_CALLBACK(media_unprepared_callback), self);
+    g_signal_connect_data(media, "unprepared", G_CALLBACK(media_unprepared_callback),
+                          ref_mount(mount), unref_mount, static_cast<GConnectFlags>(0));
     g_object_unref(element);
+    lock.unlock();
+    
+    // 按需推流：通知上层开始拉取摄像头
+    if (mount->server->presence_callback_) {
+        mount->server->presence_callback_(mount->path, true);
+    }
 }
 
 void GstRtspServer::need_data_callback(GstElement* appsrc, 
                                         guint unused, 
                                         gpointer user_data) {
-    // 可选：当 appsrc 需要数据时的回调
-    // 这里我们使用 push 模式，所以不需要实现
+    // 我们使用 push 模式，这里只用于在 appsrc 开始工作时回放 GOP 缓存
+    (void)unused;
+    Mount& mount = **static_cast<MountPtr*>(user_data);
+    
+    std::lock_guard<std::mutex> lock(mount.state_mutex);
+    if (mount.gop_replay_pending && mount.video_appsrc == appsrc) {
+        replay_gop_cache(mount);
+    }
 }
 
 void GstRtspServer::media_unprepared_callback(GstRTSPMedia* media, gpointer user_data) {
-    GstRtspServer* self = static_cast<GstRtspServer*>(user_data);
+    const MountPtr& mount_ptr = *static_cast<MountPtr*>(user_data);
+    Mount& mount = *mount_ptr;
 
-    // 重置状态
-    self->first_video_frame_ = true;
-    self->first_audio_frame_ = true;
-    self->video_base_timestamp_ = 0;
-    self->audio_base_timestamp_ = 0;
+    std::lock_guard<std::mutex> lock(mount.state_mutex);
+    if (mount.media != media) {
+        // 旧的 media，appsrc 已属于新 media
+        return;
+    }
 
-    std::cout << "RTSP client disconnected, clearing appsrc" << std::endl;
+    // 重置状态（GOP 缓存保留给下一个客户端）
+    mount.gop_replay_pending = false;
+    mount.first_video_frame = true;
+    mount.first_audio_frame = true;
+    mount.video_base_timestamp = 0;
+    mount.audio_base_timestamp = 0;
 
-    if (self->video_appsrc_) {
-        g_object_unref(self->video_appsrc_);
-        self->video_appsrc_ = nullptr;
-    }
+    std::cout << "[" << mount.path << "] RTSP client disconnected, clearing appsrc" << std::endl;
+
+    release_appsrcs(mount);
     
-    if (self->audio_appsrc_) {
-        g_object_unref(self->audio_appsrc_);
-        self->audio_appsrc_ = nullptr;
+    // 最后一个客户端离开，idle linger 内没有新客户端则通知空闲
+    if (!mount.removed) {
+        mount.server->schedule_idle(mount_ptr);
     }
 }
 
-} // namespace miot
\ No newline at end of file
+gboolean GstRtspServer::unprepare_media_callback(gpointer user_data) {
+    // media 已与 mount 解绑，media_unprepared_callback 会忽略它
+    gst_rtsp_media_unprepare(GST_RTSP_MEDIA(user_data));
+    return G_SOURCE_REMOVE;
+}
+
+} // namespace miot
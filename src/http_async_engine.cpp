@@ -0,0 +1,266 @@
+/**
+ * Asynchronous HTTP Engine - Implementation
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "http_async_engine.h"
+
+#include <iostream>
+#include <algorithm>
+
+namespace miot {
+
+namespace {
+
+// Callback for libcurl to capture response
+size_t write_callback(void* contents, size_t size, size_t nmemb, std::string* userp) {
+    size_t total_size = size * nmemb;
+    userp->append(static_cast<char*>(contents), total_size);
+    return total_size;
+}
+
+} // anonymous namespace
+
+HttpAsyncEngine::HttpAsyncEngine(std::shared_ptr<HttpClientPool> pool, size_t max_in_flight)
+    : pool_(std::move(pool)),
+      multi_(nullptr),
+      running_(false),
+      max_in_flight_(std::max<size_t>(max_in_flight, 1)),
+      in_flight_(0)
+{
+    multi_ = curl_multi_init();
+    if (multi_) {
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    }
+}
+
+HttpAsyncEngine::~HttpAsyncEngine() {
+    stop();
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
+}
+
+bool HttpAsyncEngine::start() {
+    if (!multi_) {
+        std::cerr << "[HttpAsyncEngine] Failed to create curl multi handle" << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return true;
+        }
+        running_ = true;
+    }
+
+    thread_ = std::thread([this]() { event_loop(); });
+    return true;
+}
+
+void HttpAsyncEngine::stop() {
+    {
+        // Under mutex_ so no submit can slip in after the final drain below
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+
+    curl_multi_wakeup(multi_);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // Requests the loop never started
+    std::deque<std::unique_ptr<Transfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(pending_);
+    }
+    for (auto& transfer : pending) {
+        transfer->response.result = CURLE_ABORTED_BY_CALLBACK;
+        complete(*transfer);
+    }
+}
+
+void HttpAsyncEngine::set_max_in_flight(size_t max_in_flight) {
+    max_in_flight_ = std::max<size_t>(max_in_flight, 1);
+    if (running_) {
+        curl_multi_wakeup(multi_);
+    }
+}
+
+void HttpAsyncEngine::submit(HttpRequest request, HttpCallback callback) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    transfer->callback = std::move(callback);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            pending_.push_back(std::move(transfer));
+        }
+    }
+
+    if (transfer) {
+        // Not running
+        transfer->response.result = CURLE_ABORTED_BY_CALLBACK;
+        complete(*transfer);
+        return;
+    }
+    curl_multi_wakeup(multi_);
+}
+
+std::future<HttpResponse> HttpAsyncEngine::submit(HttpRequest request) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> future = promise->get_future();
+    submit(std::move(request), [promise](HttpResponse& response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+size_t HttpAsyncEngine::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+void HttpAsyncEngine::event_loop() {
+    while (running_) {
+        start_pending();
+
+        int still_running = 0;
+        curl_multi_perform(multi_, &still_running);
+
+        bool finished = false;
+        int msgs_left = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &msgs_left)) {
+            if (msg->msg == CURLMSG_DONE) {
+                finish_transfer(msg->easy_handle, msg->data.result);
+                finished = true;
+            }
+        }
+        if (finished) {
+            // Freed slots go to queued requests right away
+            continue;
+        }
+
+        // Sleeps until socket activity, a curl timeout or curl_multi_wakeup
+        curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+    }
+
+    // Abort whatever is still running
+    for (auto& pair : active_) {
+        curl_multi_remove_handle(multi_, pair.first);
+        pair.second->response.result = CURLE_ABORTED_BY_CALLBACK;
+        complete(*pair.second);
+    }
+    active_.clear();
+    in_flight_ = 0;
+}
+
+void HttpAsyncEngine::start_pending() {
+    while (active_.size() < max_in_flight_) {
+        std::unique_ptr<Transfer> transfer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.empty()) {
+                return;
+            }
+            transfer = std::move(pending_.front());
+            pending_.pop_front();
+        }
+        start_transfer(std::move(transfer));
+    }
+}
+
+bool HttpAsyncEngine::start_transfer(std::unique_ptr<Transfer> transfer) {
+    transfer->handle = pool_->acquire();
+    CURL* curl = transfer->handle.get();
+    if (!curl) {
+        std::cerr << "[HttpAsyncEngine] Failed to initialize CURL" << std::endl;
+        transfer->response.result = CURLE_FAILED_INIT;
+        complete(*transfer);
+        return false;
+    }
+
+    const HttpRequest& request = transfer->request;
+    curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+    if (request.post) {
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+    }
+
+    for (const auto& pair : request.headers) {
+        std::string header = pair.first + ": " + pair.second;
+        transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+    }
+    if (transfer->headers) {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer->headers);
+    }
+
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->response.body);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(request.timeout.count()));
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+    if (request.follow_redirects) {
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    }
+
+    CURLMcode rc = curl_multi_add_handle(multi_, curl);
+    if (rc != CURLM_OK) {
+        std::cerr << "[HttpAsyncEngine] curl_multi_add_handle failed: "
+                  << curl_multi_strerror(rc) << std::endl;
+        transfer->response.result = CURLE_FAILED_INIT;
+        complete(*transfer);
+        return false;
+    }
+
+    active_[curl] = std::move(transfer);
+    in_flight_ = active_.size();
+    return true;
+}
+
+void HttpAsyncEngine::finish_transfer(CURL* curl, CURLcode result) {
+    auto it = active_.find(curl);
+    if (it == active_.end()) {
+        return;
+    }
+
+    std::unique_ptr<Transfer> transfer = std::move(it->second);
+    active_.erase(it);
+    in_flight_ = active_.size();
+
+    curl_multi_remove_handle(multi_, curl);
+    transfer->response.result = result;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &transfer->response.status);
+
+    if (result != CURLE_OK) {
+        std::cerr << "[HttpAsyncEngine] HTTP request failed: " << curl_easy_strerror(result) << std::endl;
+    }
+    complete(*transfer);
+}
+
+void HttpAsyncEngine::complete(Transfer& transfer) {
+    if (transfer.headers) {
+        curl_slist_free_all(transfer.headers);
+        transfer.headers = nullptr;
+    }
+    // Back to the pool before the callback, which may submit more work
+    transfer.handle.reset();
+
+    if (transfer.callback) {
+        try {
+            transfer.callback(transfer.response);
+        } catch (const std::exception& e) {
+            std::cerr << "[HttpAsyncEngine] Callback error: " << e.what() << std::endl;
+        }
+    }
+}
+
+} // namespace miot
@@ -0,0 +1,148 @@
+/**
+ * HTTP Client Pool - Implementation
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "http_client_pool.h"
+
+#include <iostream>
+
+namespace miot {
+
+struct HttpClientPool::Share {
+    CURLSH* handle;
+    std::mutex mutexes[CURL_LOCK_DATA_LAST];
+
+    Share();
+    ~Share();
+
+    static void lock(CURL* curl, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlock(CURL* curl, curl_lock_data data, void* userptr);
+};
+
+HttpClientPool::Share::Share()
+    : handle(nullptr)
+{
+    // Global state is tied to the share, which outlives every handle
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    handle = curl_share_init();
+    if (!handle) {
+        return;
+    }
+    curl_share_setopt(handle, CURLSHOPT_LOCKFUNC, lock);
+    curl_share_setopt(handle, CURLSHOPT_UNLOCKFUNC, unlock);
+    curl_share_setopt(handle, CURLSHOPT_USERDATA, this);
+    // No CURL_LOCK_DATA_CONNECT: the OAuth thread and the async engine run transfers
+    // concurrently, and libcurl does not allow a shared connection cache to be used that way
+    curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+HttpClientPool::Share::~Share() {
+    // Only reached once no easy handle refers to the share any more
+    if (handle) {
+        curl_share_cleanup(handle);
+    }
+    curl_global_cleanup();
+}
+
+void HttpClientPool::Share::lock(CURL* curl, curl_lock_data data, curl_lock_access access, void* userptr) {
+    (void)curl;
+    (void)access;
+    static_cast<Share*>(userptr)->mutexes[data].lock();
+}
+
+void HttpClientPool::Share::unlock(CURL* curl, curl_lock_data data, void* userptr) {
+    (void)curl;
+    static_cast<Share*>(userptr)->mutexes[data].unlock();
+}
+
+void HttpClientPool::HandleReleaser::operator()(CURL* curl) const {
+    if (auto owner = pool.lock()) {
+        owner->release(curl);
+    } else {
+        curl_easy_cleanup(curl);
+    }
+}
+
+std::shared_ptr<HttpClientPool> HttpClientPool::create(size_t max_idle) {
+    return std::shared_ptr<HttpClientPool>(new HttpClientPool(max_idle));
+}
+
+std::shared_ptr<HttpClientPool> HttpClientPool::shared() {
+    static std::mutex mutex;
+    static std::weak_ptr<HttpClientPool> instance;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto pool = instance.lock();
+    if (!pool) {
+        pool = create();
+        instance = pool;
+    }
+    return pool;
+}
+
+HttpClientPool::HttpClientPool(size_t max_idle)
+    : max_idle_(max_idle)
+{
+    share_ = std::make_shared<Share>();
+    if (!share_->handle) {
+        std::cerr << "[HttpClientPool] Failed to create curl share, DNS and TLS sessions will not be shared"
+                  << std::endl;
+    }
+}
+
+HttpClientPool::~HttpClientPool() {
+    // Idle handles go now; handles still out (in flight) hold share_ and free it with the last one
+    for (CURL* curl : idle_) {
+        curl_easy_cleanup(curl);
+    }
+    idle_.clear();
+    share_.reset();
+}
+
+HttpClientPool::Handle HttpClientPool::acquire() {
+    CURL* curl = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (!idle_.empty()) {
+            curl = idle_.back();
+            idle_.pop_back();
+        }
+    }
+
+    if (curl) {
+        // Clears per-request options; live connections and caches are kept
+        curl_easy_reset(curl);
+    } else {
+        curl = curl_easy_init();
+        if (!curl) {
+            return Handle(nullptr, HandleReleaser{weak_from_this(), share_});
+        }
+    }
+
+    if (share_->handle) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share_->handle);
+    }
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+    curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+    return Handle(curl, HandleReleaser{weak_from_this(), share_});
+}
+
+void HttpClientPool::release(CURL* curl) {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (idle_.size() < max_idle_) {
+            idle_.push_back(curl);
+            return;
+        }
+    }
+    curl_easy_cleanup(curl);
+}
+
+} // namespace miot
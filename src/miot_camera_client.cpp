@@ -59,7 +59,9 @@ MIoTCameraClient::MIoTCameraClient(
 ) : lib_handle_(nullptr),
     cloud_server_(cloud_server),
     access_token_(access_token),
-    lib_path_(lib_path)
+    library_initialized_(false),
+    lib_path_(lib_path),
+    lib_()
 {
     host_ = OAUTH2_API_HOST_DEFAULT;
     if (cloud_server != "cn") {
@@ -70,17 +72,24 @@ MIoTCameraClient::MIoTCameraClient(
 }
 
 MIoTCameraClient::~MIoTCameraClient() {
-    // Stop and destroy all cameras
-    std::lock_guard<std::mutex> lock(cameras_mutex_);
-    for (auto& pair : cameras_) {
+    // Stop and destroy all cameras; taken out of the map first so callbacks
+    // that call back into the client do not deadlock against the joins below
+    std::map<std::string, std::unique_ptr<CameraInstance>> cameras;
+    {
+        std::lock_guard<std::mutex> lock(cameras_mutex_);
+        cameras.swap(cameras_);
+    }
+    for (auto& pair : cameras) {
+        release_slot(*pair.second);
         if (lib_.miot_camera_stop) {
-            lib_.miot_camera_stop(pair.second.ptr);
+            lib_.miot_camera_stop(pair.second->ptr);
         }
         if (lib_.miot_camera_free) {
-            lib_.miot_camera_free(pair.second.ptr);
+            lib_.miot_camera_free(pair.second->ptr);
         }
+        stop_dispatch(*pair.second);
     }
-    cameras_.clear();
+    cameras.clear();
     
     // Deinit library
     if (lib_.miot_camera_deinit) {
@@ -229,12 +238,17 @@ bool MIoTCameraClient::bind_functions() {
     return true;
 }
 
-bool MIoTCameraClient::init() {
+bool MIoTCameraClient::load() {
+    if (lib_handle_) {
+        return true;
+    }
+    
     if (!load_library()) {
         return false;
     }
     
     if (!bind_functions()) {
+        unload_library();
         return false;
     }
     
@@ -244,17 +258,27 @@ bool MIoTCameraClient::init() {
         static_cast<LogCallback>(log_callback)
     ));
     
+    return true;
+}
+
+bool MIoTCameraClient::init() {
+    if (!load()) {
+        return false;
+    }
+    
     // Initialize library
+    std::unique_lock<std::mutex> token_lock(token_mutex_);
     int result = lib_.miot_camera_init(
         host_.c_str(),
         OAUTH2_CLIENT_ID,
         access_token_.c_str()
     );
-    
     if (result != 0) {
         std::cerr << "[MIoTCameraClient] Failed to initialize library: " << result << std::endl;
         return false;
     }
+    library_initialized_ = true;
+    token_lock.unlock();
     
     std::cout << "[MIoTCameraClient] Initialized successfully" << std::endl;
     std::cout << "[MIoTCameraClient] Library version: " << get_version() << std::endl;
@@ -285,13 +309,26 @@ bool MIoTCameraClient::create_camera(const std::string& did, const std::string&
     }
     
     // Store camera instance
-    CameraInstance instance;
-    instance.ptr = ptr;
-    instance.did = did;
-    instance.model = model;
-    instance.channel_count = channel_count;
+    auto instance = std::make_unique<CameraInstance>();
+    instance->ptr = ptr;
+    instance->did = did;
+    instance->model = model;
+    instance->channel_count = channel_count;
+    instance->slot = MAX_CAMERA_SLOTS;
+    instance->frame_pool = FrameBufferPool::create(pool_config_);
+    instance->frame_ring = std::make_unique<SpscRing<RawFrameData>>(queue_config_.capacity);
+    instance->overflow_policy = queue_config_.policy;
+    instance->waiting_keyframe = false;
+    
+    if (!acquire_slot(*instance)) {
+        std::cerr << "[MIoTCameraClient] No free callback slot for camera: " << did
+                  << " (max " << MAX_CAMERA_SLOTS << ")" << std::endl;
+        lib_.miot_camera_free(ptr);
+        return false;
+    }
     
-    cameras_[did] = instance;
+    start_dispatch(*instance);
+    cameras_[did] = std::move(instance);
     
     std::cout << "[MIoTCameraClient] Camera created: " << did << " (" << model << ")" << std::endl;
     return true;
@@ -311,7 +348,7 @@ bool MIoTCameraClient::start_camera(
             std::cerr << "[MIoTCameraClient] Camera not found: " << did << std::endl;
             return false;
         }
-        camera_ptr = it->second.ptr;
+        camera_ptr = it->second->ptr;
     }
     
     // Prepare quality array (terminated with 0)
@@ -344,7 +381,7 @@ bool MIoTCameraClient::stop_camera(const std::string& did) {
             std::cerr << "[MIoTCameraClient] Camera not found: " << did << std::endl;
             return false;
         }
-        camera_ptr = it->second.ptr;
+        camera_ptr = it->second->ptr;
     }
     
     int result = lib_.miot_camera_stop(camera_ptr);
@@ -358,15 +395,23 @@ bool MIoTCameraClient::stop_camera(const std::string& did) {
 }
 
 void MIoTCameraClient::destroy_camera(const std::string& did) {
-    std::lock_guard<std::mutex> lock(cameras_mutex_);
-    
-    auto it = cameras_.find(did);
-    if (it == cameras_.end()) {
-        return;
+    std::unique_ptr<CameraInstance> camera;
+    {
+        std::lock_guard<std::mutex> lock(cameras_mutex_);
+        
+        auto it = cameras_.find(did);
+        if (it == cameras_.end()) {
+            return;
+        }
+        camera = std::move(it->second);
+        cameras_.erase(it);
     }
     
-    lib_.miot_camera_free(it->second.ptr);
-    cameras_.erase(it);
+    // Outside cameras_mutex_: joining the dispatch worker waits for user
+    // callbacks, which may call back into the client
+    release_slot(*camera);
+    lib_.miot_camera_free(camera->ptr);
+    stop_dispatch(*camera);
     
     std::cout << "[MIoTCameraClient] Camera destroyed: " << did << std::endl;
 }
@@ -380,13 +425,18 @@ void MIoTCameraClient::register_raw_video_callback(const std::string& did, int c
         return;
     }
     
-    it->second.video_callbacks[channel] = callback;
+    {
+        std::lock_guard<std::mutex> callbacks_lock(it->second->callbacks_mutex);
+        it->second->video_callbacks[channel] = callback;
+    }
     
     // Register raw data callback with library
-    using RawDataCallback = void(*)(const void*, const uint8_t*);
+    RawDataTrampoline trampoline = raw_data_trampoline_at(
+        it->second->slot, std::make_index_sequence<MAX_CAMERA_SLOTS>{}
+    );
     lib_.miot_camera_register_raw_data(
-        it->second.ptr,
-        reinterpret_cast<void*>(static_cast<RawDataCallback>(raw_data_callback)),
+        it->second->ptr,
+        reinterpret_cast<void*>(trampoline),
         static_cast<uint8_t>(channel)
     );
     
@@ -403,7 +453,10 @@ void MIoTCameraClient::register_raw_audio_callback(const std::string& did, int c
         return;
     }
     
-    it->second.audio_callbacks[channel] = callback;
+    {
+        std::lock_guard<std::mutex> callbacks_lock(it->second->callbacks_mutex);
+        it->second->audio_callbacks[channel] = callback;
+    }
     std::cout << "[MIoTCameraClient] Registered audio callback: " << did 
               << ", channel: " << channel << std::endl;
 }
@@ -417,13 +470,18 @@ void MIoTCameraClient::register_status_callback(const std::string& did, StatusCh
         return;
     }
     
-    it->second.status_callback = callback;
+    {
+        std::lock_guard<std::mutex> callbacks_lock(it->second->callbacks_mutex);
+        it->second->status_callback = callback;
+    }
     
     // Register status callback with library
-    using StatusCallback = void(*)(int);
+    StatusTrampoline trampoline = status_trampoline_at(
+        it->second->slot, std::make_index_sequence<MAX_CAMERA_SLOTS>{}
+    );
     lib_.miot_camera_register_status_changed(
-        it->second.ptr,
-        reinterpret_cast<void*>(static_cast<StatusCallback>(status_callback))
+        it->second->ptr,
+        reinterpret_cast<void*>(trampoline)
     );
     
     std::cout << "[MIoTCameraClient] Registered status callback: " << did << std::endl;
@@ -437,7 +495,7 @@ CameraStatus MIoTCameraClient::get_status(const std::string& did) {
         return CameraStatus::DISCONNECTED;
     }
     
-    int status = lib_.miot_camera_status(it->second.ptr);
+    int status = lib_.miot_camera_status(it->second->ptr);
     return static_cast<CameraStatus>(status);
 }
 
@@ -450,6 +508,62 @@ std::string MIoTCameraClient::get_version() {
     return version ? std::string(version) : "unknown";
 }
 
+bool MIoTCameraClient::update_access_token(const std::string& access_token) {
+    std::lock_guard<std::mutex> lock(token_mutex_);
+    access_token_ = access_token;
+    
+    if (!library_initialized_) {
+        // Not initialized yet, init() picks up the stored token
+        return false;
+    }
+    
+    int result = lib_.miot_camera_update_access_token(access_token_.c_str());
+    if (result != 0) {
+        std::cerr << "[MIoTCameraClient] Failed to update access token: " << result << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void MIoTCameraClient::set_frame_queue_config(const FrameQueueConfig& config) {
+    std::lock_guard<std::mutex> lock(cameras_mutex_);
+    queue_config_ = config;
+}
+
+FrameQueueStats MIoTCameraClient::get_frame_queue_stats(const std::string& did) {
+    std::lock_guard<std::mutex> lock(cameras_mutex_);
+    
+    FrameQueueStats stats;
+    auto it = cameras_.find(did);
+    if (it == cameras_.end()) {
+        return stats;
+    }
+    
+    const CameraInstance& camera = *it->second;
+    stats.enqueued = camera.frames_enqueued.load();
+    stats.dispatched = camera.frames_dispatched.load();
+    stats.dropped = camera.frames_dropped.load();
+    stats.overflows = camera.queue_overflows.load();
+    stats.depth = camera.frame_ring->size();
+    stats.capacity = camera.frame_ring->capacity();
+    return stats;
+}
+
+void MIoTCameraClient::set_frame_pool_config(const FrameBufferPoolConfig& config) {
+    std::lock_guard<std::mutex> lock(cameras_mutex_);
+    pool_config_ = config;
+}
+
+FrameBufferPoolStats MIoTCameraClient::get_frame_pool_stats(const std::string& did) {
+    std::lock_guard<std::mutex> lock(cameras_mutex_);
+    
+    auto it = cameras_.find(did);
+    if (it == cameras_.end()) {
+        return FrameBufferPoolStats();
+    }
+    return it->second->frame_pool->stats();
+}
+
 // Static callback implementations
 void MIoTCameraClient::log_callback(int level, const char* msg) {
     const char* level_str = "INFO";
@@ -462,80 +576,228 @@ void MIoTCameraClient::log_callback(int level, const char* msg) {
     std::cout << "[libmiot_camera][" << level_str << "] " << msg << std::endl;
 }
 
-void MIoTCameraClient::raw_data_callback(const void* frame_header, const uint8_t* data) {
-    if (!instance_) {
+bool MIoTCameraClient::acquire_slot(CameraInstance& camera) {
+    for (size_t i = 0; i < MAX_CAMERA_SLOTS; ++i) {
+        if (!slots_[i].camera.load()) {
+            camera.slot = i;
+            slots_[i].camera.store(&camera);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MIoTCameraClient::release_slot(CameraInstance& camera) {
+    if (camera.slot >= MAX_CAMERA_SLOTS) {
         return;
     }
     
-    // This is called from library thread, so we need to be careful
-    // For now, we'll process it synchronously
-    // In production, you might want to queue this for processing in another thread
+    CallbackSlot& slot = slots_[camera.slot];
+    slot.camera.store(nullptr);
+    // Wait for library callbacks that already picked up the camera
+    while (slot.active.load() != 0) {
+        std::this_thread::yield();
+    }
+    camera.slot = MAX_CAMERA_SLOTS;
+}
+
+void MIoTCameraClient::start_dispatch(CameraInstance& camera) {
+    camera.dispatch_running = true;
+    camera.dispatch_thread = std::thread([this, &camera]() { dispatch_loop(camera); });
+}
+
+void MIoTCameraClient::stop_dispatch(CameraInstance& camera) {
+    {
+        std::lock_guard<std::mutex> lock(camera.wake_mutex);
+        camera.dispatch_running = false;
+    }
+    camera.wake_cv.notify_one();
     
-    // We need to find which camera this belongs to
-    // The library doesn't pass the camera instance, so we'll process for all cameras
-    // This is a limitation - in practice you might need a more sophisticated approach
+    if (camera.dispatch_thread.joinable()) {
+        camera.dispatch_thread.join();
+    }
+}
+
+void MIoTCameraClient::wake_dispatch(CameraInstance& camera) {
+    // Pairs with the fence in dispatch_loop(): either the worker sees the new
+    // frame before sleeping, or we see it waiting and notify it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (camera.consumer_waiting.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(camera.wake_mutex);
+        camera.wake_cv.notify_one();
+    }
+}
+
+void MIoTCameraClient::dispatch_loop(CameraInstance& camera) {
+    RawFrameData frame;
+    std::deque<int> statuses;
     
-    std::lock_guard<std::mutex> lock(instance_->cameras_mutex_);
-    for (auto& pair : instance_->cameras_) {
-        instance_->handle_raw_data(pair.first, frame_header, data);
+    while (true) {
+        while (camera.frame_ring->try_pop(frame)) {
+            handle_raw_data(camera, frame);
+            camera.frames_dispatched++;
+        }
+        // Release the last payload before sleeping
+        frame = RawFrameData();
+        
+        std::unique_lock<std::mutex> lock(camera.wake_mutex);
+        statuses.swap(camera.pending_status);
+        if (statuses.empty()) {
+            camera.consumer_waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            camera.wake_cv.wait(lock, [&camera]() {
+                return !camera.dispatch_running || !camera.frame_ring->empty() ||
+                       !camera.pending_status.empty();
+            });
+            camera.consumer_waiting.store(false, std::memory_order_relaxed);
+            if (!camera.dispatch_running) {
+                break;
+            }
+            continue;
+        }
+        lock.unlock();
+        
+        for (int status : statuses) {
+            handle_status_change(camera, status);
+        }
+        statuses.clear();
     }
 }
 
-void MIoTCameraClient::status_callback(int status) {
+template <size_t Slot>
+void MIoTCameraClient::raw_data_trampoline(const void* frame_header, const uint8_t* data) {
     if (!instance_) {
         return;
     }
-    
-    std::lock_guard<std::mutex> lock(instance_->cameras_mutex_);
-    for (auto& pair : instance_->cameras_) {
-        instance_->handle_status_change(pair.first, status);
+    instance_->dispatch_raw_data(Slot, frame_header, data);
+}
+
+template <size_t Slot>
+void MIoTCameraClient::status_trampoline(int status) {
+    if (!instance_) {
+        return;
     }
+    instance_->dispatch_status_change(Slot, status);
 }
 
-void MIoTCameraClient::handle_raw_data(const std::string& did, const void* frame_header_ptr, const uint8_t* data) {
+template <size_t... Slots>
+MIoTCameraClient::RawDataTrampoline MIoTCameraClient::raw_data_trampoline_at(
+    size_t slot, std::index_sequence<Slots...>
+) {
+    static constexpr RawDataTrampoline table[] = {&raw_data_trampoline<Slots>...};
+    return table[slot];
+}
+
+template <size_t... Slots>
+MIoTCameraClient::StatusTrampoline MIoTCameraClient::status_trampoline_at(
+    size_t slot, std::index_sequence<Slots...>
+) {
+    static constexpr StatusTrampoline table[] = {&status_trampoline<Slots>...};
+    return table[slot];
+}
+
+void MIoTCameraClient::dispatch_raw_data(size_t slot, const void* frame_header, const uint8_t* data) {
+    // Called from library thread; the slot identifies the owning camera.
+    // Only copy the frame and enqueue it here, callbacks run on the dispatch worker.
+    CallbackSlot& callback_slot = slots_[slot];
+    callback_slot.active++;
+    CameraInstance* camera = callback_slot.camera.load();
+    if (camera) {
+        enqueue_raw_data(*camera, frame_header, data);
+    }
+    callback_slot.active--;
+}
+
+void MIoTCameraClient::dispatch_status_change(size_t slot, int status) {
+    CallbackSlot& callback_slot = slots_[slot];
+    callback_slot.active++;
+    CameraInstance* camera = callback_slot.camera.load();
+    if (camera) {
+        {
+            std::lock_guard<std::mutex> lock(camera->wake_mutex);
+            camera->pending_status.push_back(status);
+        }
+        camera->wake_cv.notify_one();
+    }
+    callback_slot.active--;
+}
+
+void MIoTCameraClient::enqueue_raw_data(CameraInstance& camera, const void* frame_header_ptr, const uint8_t* data) {
     auto* header = static_cast<const CameraFrameHeaderC*>(frame_header_ptr);
     
+    auto codec = static_cast<CameraCodec>(header->codec_id);
+    auto frame_type = static_cast<FrameType>(header->frame_type);
+    bool is_video = (codec == CameraCodec::VIDEO_H264 || codec == CameraCodec::VIDEO_H265);
+    
+    // After an overflow, P frames are useless until the next I frame
+    if (is_video && camera.waiting_keyframe) {
+        if (frame_type != FrameType::I_FRAME) {
+            camera.frames_dropped++;
+            return;
+        }
+        camera.waiting_keyframe = false;
+    }
+    
+    // Decide before copying: a frame that is going to be dropped is not worth a copy,
+    // least of all when the dispatch worker is already behind
+    if (camera.frame_ring->full()) {
+        camera.queue_overflows++;
+        camera.frames_dropped++;
+        if (is_video && camera.overflow_policy == OverflowPolicy::DROP_UNTIL_KEYFRAME) {
+            camera.waiting_keyframe = true;
+        }
+        return;
+    }
+    
     RawFrameData frame;
-    frame.codec_id = static_cast<CameraCodec>(header->codec_id);
+    frame.codec_id = codec;
     frame.length = header->length;
     frame.timestamp = header->timestamp;
     frame.sequence = header->sequence;
-    frame.frame_type = static_cast<FrameType>(header->frame_type);
+    frame.frame_type = frame_type;
     frame.channel = header->channel;
-    frame.data.assign(data, data + header->length);
+    frame.buffer = camera.frame_pool->copy_from(data, header->length);
     
-    auto it = cameras_.find(did);
-    if (it == cameras_.end()) {
+    if (!frame.buffer) {
+        // Pool byte cap reached, consumers are holding on to too many frames
+        camera.frames_dropped++;
+        if (is_video && camera.overflow_policy == OverflowPolicy::DROP_UNTIL_KEYFRAME) {
+            camera.waiting_keyframe = true;
+        }
         return;
     }
     
+    // Cannot fail: this is the only producer and the ring had room above
+    camera.frame_ring->try_push(std::move(frame));
+    camera.frames_enqueued++;
+    wake_dispatch(camera);
+}
+
+void MIoTCameraClient::handle_raw_data(CameraInstance& camera, const RawFrameData& frame) {
+    std::lock_guard<std::mutex> lock(camera.callbacks_mutex);
+    
     // Check if it's video or audio
     if (frame.codec_id == CameraCodec::VIDEO_H264 || frame.codec_id == CameraCodec::VIDEO_H265) {
         // Video frame
-        auto callback_it = it->second.video_callbacks.find(frame.channel);
-        if (callback_it != it->second.video_callbacks.end() && callback_it->second) {
-            callback_it->second(did, frame);
+        auto callback_it = camera.video_callbacks.find(frame.channel);
+        if (callback_it != camera.video_callbacks.end() && callback_it->second) {
+            callback_it->second(camera.did, frame);
         }
     } else {
         // Audio frame
-        auto callback_it = it->second.audio_callbacks.find(frame.channel);
-        if (callback_it != it->second.audio_callbacks.end() && callback_it->second) {
-            callback_it->second(did, frame);
+        auto callback_it = camera.audio_callbacks.find(frame.channel);
+        if (callback_it != camera.audio_callbacks.end() && callback_it->second) {
+            callback_it->second(camera.did, frame);
         }
     }
 }
 
-void MIoTCameraClient::handle_status_change(const std::string& did, int status) {
-    auto it = cameras_.find(did);
-    if (it == cameras_.end()) {
-        return;
-    }
-    
-    if (it->second.status_callback) {
-        it->second.status_callback(did, static_cast<CameraStatus>(status));
+void MIoTCameraClient::handle_status_change(CameraInstance& camera, int status) {
+    std::lock_guard<std::mutex> lock(camera.callbacks_mutex);
+    if (camera.status_callback) {
+        camera.status_callback(camera.did, static_cast<CameraStatus>(status));
     }
 }
 
-
 } // namespace miot
 
@@ -6,6 +6,7 @@
  */
 
 #include "miot_cloud_client.h"
+#include "base64.h"
 
 #include <iostream>
 #include <sstream>
@@ -14,13 +15,7 @@
 #include <algorithm>
 
 // OpenSSL includes
-#include <openssl/aes.h>
-#include <openssl/rsa.h>
-#include <openssl/pem.h>
-#include <openssl/bio.h>
 #include <openssl/evp.h>
-#include <openssl/buffer.h>
-#include <openssl/rand.h>
 #include <openssl/err.h>
 
 // libcurl for HTTP
@@ -28,21 +23,15 @@
 
 namespace miot {
 
-namespace {
-
-// Callback for libcurl to capture response
-size_t write_callback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    size_t total_size = size * nmemb;
-    userp->append(static_cast<char*>(contents), total_size);
-    return total_size;
-}
-
-} // anonymous namespace
-
 MIoTCloudClient::MIoTCloudClient(const std::string& access_token, const std::string& cloud_server)
     : access_token_(access_token),
       cloud_server_(cloud_server),
-      host_(OAUTH2_API_HOST_DEFAULT)
+      host_(OAUTH2_API_HOST_DEFAULT),
+      http_engine_(new HttpAsyncEngine(HttpClientPool::shared())),
+      request_timeout_ms_(30000),
+      lookup_window_(50),
+      lookup_max_batch_(200),
+      lookup_stopping_(false)
 {
     if (cloud_server != "cn") {
         host_ = cloud_server + "." + OAUTH2_API_HOST_DEFAULT;
@@ -55,18 +44,27 @@ MIoTCloudClient::MIoTCloudClient(const std::string& access_token, const std::str
     
     // Initialize libcurl
     curl_global_init(CURL_GLOBAL_DEFAULT);
+    
+    http_engine_->start();
 }
 
 MIoTCloudClient::~MIoTCloudClient() {
+    {
+        std::lock_guard<std::mutex> lock(lookup_mutex_);
+        lookup_stopping_ = true;
+    }
+    lookup_cv_.notify_all();
+    if (lookup_thread_.joinable()) {
+        lookup_thread_.join();
+    }
+    
+    // Fails whatever is still in flight
+    http_engine_.reset();
+    
     curl_global_cleanup();
 }
 
 bool MIoTCloudClient::init() {
-    if (!generate_aes_key()) {
-        std::cerr << "[MIoTCloudClient] Failed to generate AES key" << std::endl;
-        return false;
-    }
-    
     if (!generate_client_secret()) {
         std::cerr << "[MIoTCloudClient] Failed to generate client secret" << std::endl;
         return false;
@@ -76,198 +74,43 @@ bool MIoTCloudClient::init() {
     return true;
 }
 
-bool MIoTCloudClient::generate_aes_key() {
-    aes_key_.resize(16);
-    if (RAND_bytes(aes_key_.data(), 16) != 1) {
-        return false;
-    }
-    return true;
-}
-
 bool MIoTCloudClient::generate_client_secret() {
-    // Load public key
-    BIO* bio = BIO_new_mem_buf(MIHOME_HTTP_API_PUBKEY, -1);
-    if (!bio) {
-        return false;
-    }
-    
-    EVP_PKEY* pkey = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
-    BIO_free(bio);
-    
-    if (!pkey) {
+    // Parses the public key once and creates the session AES key
+    if (!crypto_.init(MIHOME_HTTP_API_PUBKEY)) {
         return false;
     }
     
     // RSA encrypt the AES key
-    std::vector<uint8_t> encrypted = rsa_encrypt(aes_key_.data(), aes_key_.size());
-    EVP_PKEY_free(pkey);
-    
+    const std::vector<uint8_t>& key = crypto_.key();
+    std::vector<uint8_t> encrypted = crypto_.rsa_encrypt(key.data(), key.size());
     if (encrypted.empty()) {
         return false;
     }
     
     // Base64 encode
-    client_secret_b64_ = base64_encode(encrypted.data(), encrypted.size());
+    client_secret_b64_ = Base64::encode(encrypted.data(), encrypted.size());
     return true;
 }
 
-std::vector<uint8_t> MIoTCloudClient::rsa_encrypt(const uint8_t* data, size_t len) {
-    BIO* bio = BIO_new_mem_buf(MIHOME_HTTP_API_PUBKEY, -1);
-    if (!bio) {
-        return {};
-    }
-    
-    EVP_PKEY* pkey = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
-    BIO_free(bio);
-    
-    if (!pkey) {
-        return {};
-    }
-    
-    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new(pkey, nullptr);
-    if (!ctx) {
-        EVP_PKEY_free(pkey);
-        return {};
-    }
-    
-    if (EVP_PKEY_encrypt_init(ctx) <= 0) {
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
-        return {};
-    }
-    
-    if (EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_PADDING) <= 0) {
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
-        return {};
-    }
-    
-    size_t outlen;
-    if (EVP_PKEY_encrypt(ctx, nullptr, &outlen, data, len) <= 0) {
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
-        return {};
-    }
-    
-    std::vector<uint8_t> result(outlen);
-    if (EVP_PKEY_encrypt(ctx, result.data(), &outlen, data, len) <= 0) {
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
-        return {};
-    }
-    
-    result.resize(outlen);
-    EVP_PKEY_CTX_free(ctx);
-    EVP_PKEY_free(pkey);
-    
-    return result;
-}
-
-std::string MIoTCloudClient::base64_encode(const uint8_t* data, size_t len) {
-    BIO* bio = BIO_new(BIO_s_mem());
-    BIO* b64 = BIO_new(BIO_f_base64());
-    bio = BIO_push(b64, bio);
-    
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    BIO_write(bio, data, len);
-    BIO_flush(bio);
-    
-    BUF_MEM* buf_mem;
-    BIO_get_mem_ptr(bio, &buf_mem);
-    
-    std::string result(buf_mem->data, buf_mem->length);
-    BIO_free_all(bio);
-    
-    return result;
-}
-
-std::vector<uint8_t> MIoTCloudClient::base64_decode(const std::string& encoded) {
-    BIO* bio = BIO_new_mem_buf(encoded.data(), encoded.size());
-    BIO* b64 = BIO_new(BIO_f_base64());
-    bio = BIO_push(b64, bio);
-    
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    
-    std::vector<uint8_t> result(encoded.size());
-    int decoded_len = BIO_read(bio, result.data(), encoded.size());
-    BIO_free_all(bio);
-    
-    if (decoded_len > 0) {
-        result.resize(decoded_len);
-    } else {
-        result.clear();
-    }
-    
-    return result;
-}
-
-std::vector<uint8_t> MIoTCloudClient::pkcs7_pad(const std::vector<uint8_t>& data, size_t block_size) {
-    size_t padding = block_size - (data.size() % block_size);
-    std::vector<uint8_t> padded = data;
-    padded.insert(padded.end(), padding, static_cast<uint8_t>(padding));
-    return padded;
-}
-
-std::vector<uint8_t> MIoTCloudClient::pkcs7_unpad(const std::vector<uint8_t>& data) {
-    if (data.empty()) {
-        return {};
-    }
-    
-    uint8_t padding = data.back();
-    if (padding > data.size() || padding > 16) {
-        return data;
-    }
-    
-    std::vector<uint8_t> unpadded(data.begin(), data.end() - padding);
-    return unpadded;
-}
-
-std::vector<uint8_t> MIoTCloudClient::aes_cbc_encrypt(const std::vector<uint8_t>& plaintext) {
-    // Pad the plaintext
-    std::vector<uint8_t> padded = pkcs7_pad(plaintext, AES_BLOCK_SIZE);
-    
-    std::vector<uint8_t> ciphertext(padded.size());
-    
-    AES_KEY aes_key;
-    AES_set_encrypt_key(aes_key_.data(), 128, &aes_key);
-    
-    // Use AES key as IV (same as Python implementation)
-    uint8_t iv[AES_BLOCK_SIZE];
-    std::memcpy(iv, aes_key_.data(), AES_BLOCK_SIZE);
-    
-    AES_cbc_encrypt(padded.data(), ciphertext.data(), padded.size(), &aes_key, iv, AES_ENCRYPT);
-    
-    return ciphertext;
-}
-
-std::vector<uint8_t> MIoTCloudClient::aes_cbc_decrypt(const std::vector<uint8_t>& ciphertext) {
-    std::vector<uint8_t> plaintext(ciphertext.size());
-    
-    AES_KEY aes_key;
-    AES_set_decrypt_key(aes_key_.data(), 128, &aes_key);
-    
-    // Use AES key as IV
-    uint8_t iv[AES_BLOCK_SIZE];
-    std::memcpy(iv, aes_key_.data(), AES_BLOCK_SIZE);
-    
-    AES_cbc_encrypt(ciphertext.data(), plaintext.data(), ciphertext.size(), &aes_key, iv, AES_DECRYPT);
-    
-    return pkcs7_unpad(plaintext);
-}
-
 std::string MIoTCloudClient::aes_encrypt_with_b64(const std::string& json_data) {
-    std::vector<uint8_t> plaintext(json_data.begin(), json_data.end());
-    std::vector<uint8_t> encrypted = aes_cbc_encrypt(plaintext);
-    return base64_encode(encrypted.data(), encrypted.size());
+    std::vector<uint8_t> encrypted;
+    if (!crypto_.encrypt(reinterpret_cast<const uint8_t*>(json_data.data()), json_data.size(), encrypted)) {
+        return "";
+    }
+    return Base64::encode(encrypted.data(), encrypted.size());
 }
 
 std::string MIoTCloudClient::aes_decrypt_with_b64(const std::string& encrypted_b64) {
-    std::vector<uint8_t> encrypted = base64_decode(encrypted_b64);
-    if (encrypted.empty()) {
+    // Decoded straight into the AES input buffer
+    std::vector<uint8_t> encrypted;
+    if (!Base64::decode(encrypted_b64, encrypted) || encrypted.empty()) {
         return "";
     }
     
-    std::vector<uint8_t> decrypted = aes_cbc_decrypt(encrypted);
+    std::vector<uint8_t> decrypted;
+    if (!crypto_.decrypt(encrypted.data(), encrypted.size(), decrypted)) {
+        return "";
+    }
     return std::string(decrypted.begin(), decrypted.end());
 }
 
@@ -280,67 +123,54 @@ std::map<std::string, std::string> MIoTCloudClient::get_api_headers() {
     headers["X-Client-AppId"] = OAUTH2_CLIENT_ID;
     headers["X-Client-Secret"] = client_secret_b64_;
     headers["Host"] = host_;
-    headers["Authorization"] = "Bearer" + access_token_;
+    {
+        std::lock_guard<std::mutex> lock(token_mutex_);
+        headers["Authorization"] = "Bearer" + access_token_;
+    }
     return headers;
 }
 
-std::string MIoTCloudClient::http_post(const std::string& url_path, const std::string& encrypted_data) {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        std::cerr << "[MIoTCloudClient] Failed to initialize CURL" << std::endl;
-        return "";
+HttpRequest MIoTCloudClient::build_api_request(const std::string& url_path, const std::string& encrypted_data) {
+    HttpRequest request;
+    request.url = base_url_ + url_path;
+    request.post = true;
+    request.body = encrypted_data;
+    request.headers = get_api_headers();
+    request.timeout = std::chrono::milliseconds(request_timeout_ms_.load());
+    return request;
+}
+
+std::map<std::string, CloudDeviceInfo> MIoTCloudClient::parse_device_list(const HttpResponse& response) {
+    if (response.result != CURLE_OK) {
+        return {};
     }
     
-    std::string url = base_url_ + url_path;
-    std::string response;
-    
-    // Set URL
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    
-    // Set POST data
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, encrypted_data.c_str());
-    
-    // Set headers
-    struct curl_slist* headers = nullptr;
-    auto api_headers = get_api_headers();
-    for (const auto& pair : api_headers) {
-        std::string header = pair.first + ": " + pair.second;
-        headers = curl_slist_append(headers, header.c_str());
+    if (response.status != 200) {
+        std::cerr << "[MIoTCloudClient] HTTP error code: " << response.status << std::endl;
+        return {};
     }
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    
-    // Set write callback
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    
-    // Set timeout
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
     
-    // Perform request
-    CURLcode res = curl_easy_perform(curl);
-    
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-    
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK) {
-        std::cerr << "[MIoTCloudClient] HTTP request failed: " << curl_easy_strerror(res) << std::endl;
-        return "";
+    if (response.body.empty()) {
+        std::cerr << "[MIoTCloudClient] Empty response from server" << std::endl;
+        return {};
     }
     
-    if (http_code != 200) {
-        std::cerr << "[MIoTCloudClient] HTTP error code: " << http_code << std::endl;
-        return "";
+    // Decrypt response
+    std::string decrypted = aes_decrypt_with_b64(response.body);
+    if (decrypted.empty()) {
+        std::cerr << "[MIoTCloudClient] Failed to decrypt response" << std::endl;
+        return {};
     }
     
-    return response;
+    // Parse response JSON
+    return SimpleJson::parse_device_list_response(decrypted);
 }
 
-std::map<std::string, CloudDeviceInfo> MIoTCloudClient::get_devices(const std::vector<std::string>& dids) {
+void MIoTCloudClient::get_devices_async(const std::vector<std::string>& dids,
+                                        std::function<void(std::map<std::string, CloudDeviceInfo>)> callback) {
     if (dids.empty()) {
-        return {};
+        callback({});
+        return;
     }
     
     // Build request JSON
@@ -349,37 +179,132 @@ std::map<std::string, CloudDeviceInfo> MIoTCloudClient::get_devices(const std::v
     // Encrypt request
     std::string encrypted = aes_encrypt_with_b64(request_json);
     
-    // Send HTTP POST
-    std::string response = http_post("/app/v2/home/device_list_page", encrypted);
-    if (response.empty()) {
-        std::cerr << "[MIoTCloudClient] Empty response from server" << std::endl;
-        return {};
+    // Send HTTP POST, response is decrypted and parsed on the engine thread
+    http_engine_->submit(build_api_request("/app/v2/home/device_list_page", encrypted),
+                         [this, callback](HttpResponse& response) {
+                             callback(parse_device_list(response));
+                         });
+}
+
+std::future<std::map<std::string, CloudDeviceInfo>> MIoTCloudClient::get_devices_async(const std::vector<std::string>& dids) {
+    auto promise = std::make_shared<std::promise<std::map<std::string, CloudDeviceInfo>>>();
+    auto future = promise->get_future();
+    get_devices_async(dids, [promise](std::map<std::string, CloudDeviceInfo> devices) {
+        promise->set_value(std::move(devices));
+    });
+    return future;
+}
+
+std::map<std::string, CloudDeviceInfo> MIoTCloudClient::get_devices(const std::vector<std::string>& dids) {
+    // Must not be called from an HTTP engine callback
+    return get_devices_async(dids).get();
+}
+
+CloudDeviceInfo MIoTCloudClient::get_device(const std::string& did) {
+    return get_device_async(did).get();
+}
+
+std::shared_future<CloudDeviceInfo> MIoTCloudClient::get_device_async(const std::string& did) {
+    std::lock_guard<std::mutex> lock(lookup_mutex_);
+    
+    // Same DID already waiting for the next batch
+    auto it = pending_lookups_.find(did);
+    if (it != pending_lookups_.end()) {
+        return it->second.future;
     }
     
-    // Decrypt response
-    std::string decrypted = aes_decrypt_with_b64(response);
-    if (decrypted.empty()) {
-        std::cerr << "[MIoTCloudClient] Failed to decrypt response" << std::endl;
-        return {};
+    if (lookup_stopping_) {
+        std::promise<CloudDeviceInfo> promise;
+        promise.set_value(CloudDeviceInfo());
+        return promise.get_future().share();
     }
     
-    // Parse response JSON
-    return SimpleJson::parse_device_list_response(decrypted);
+    if (!lookup_thread_.joinable()) {
+        lookup_thread_ = std::thread([this]() { lookup_loop(); });
+    }
+    
+    // The window starts with the first DID of a batch
+    if (pending_lookups_.empty()) {
+        lookup_deadline_ = std::chrono::steady_clock::now() + lookup_window_;
+    }
+    
+    PendingLookup& lookup = pending_lookups_[did];
+    lookup.future = lookup.promise.get_future().share();
+    
+    if (pending_lookups_.size() == 1 || pending_lookups_.size() >= lookup_max_batch_) {
+        lookup_cv_.notify_one();
+    }
+    return lookup.future;
 }
 
-CloudDeviceInfo MIoTCloudClient::get_device(const std::string& did) {
-    std::vector<std::string> dids = {did};
-    auto devices = get_devices(dids);
+void MIoTCloudClient::set_lookup_batching(std::chrono::milliseconds window, size_t max_batch) {
+    std::lock_guard<std::mutex> lock(lookup_mutex_);
+    lookup_window_ = window;
+    lookup_max_batch_ = std::max<size_t>(max_batch, 1);
+}
+
+void MIoTCloudClient::set_max_in_flight(size_t max_in_flight) {
+    http_engine_->set_max_in_flight(max_in_flight);
+}
+
+void MIoTCloudClient::set_request_timeout(std::chrono::milliseconds timeout) {
+    request_timeout_ms_ = timeout.count();
+}
+
+void MIoTCloudClient::lookup_loop() {
+    std::unique_lock<std::mutex> lock(lookup_mutex_);
     
-    auto it = devices.find(did);
-    if (it != devices.end()) {
-        return it->second;
+    while (!lookup_stopping_) {
+        if (pending_lookups_.empty()) {
+            lookup_cv_.wait(lock, [this]() { return lookup_stopping_ || !pending_lookups_.empty(); });
+            continue;
+        }
+        
+        // Collect until the window closes or the batch is full
+        lookup_cv_.wait_until(lock, lookup_deadline_, [this]() {
+            return lookup_stopping_ || pending_lookups_.size() >= lookup_max_batch_;
+        });
+        if (lookup_stopping_) {
+            break;
+        }
+        
+        std::vector<std::string> dids;
+        auto promises = std::make_shared<std::vector<std::promise<CloudDeviceInfo>>>();
+        while (!pending_lookups_.empty() && dids.size() < lookup_max_batch_) {
+            auto it = pending_lookups_.begin();
+            dids.push_back(it->first);
+            promises->push_back(std::move(it->second.promise));
+            pending_lookups_.erase(it);
+        }
+        
+        // Anything left over has already waited a full window
+        lookup_deadline_ = std::chrono::steady_clock::now();
+        
+        lock.unlock();
+        
+        // Don't wait for the response, the next batch can go out while this one is in flight
+        get_devices_async(dids, [dids, promises](std::map<std::string, CloudDeviceInfo> devices) {
+            std::cout << "[MIoTCloudClient] Batched lookup: " << dids.size() << " devices, " 
+                      << devices.size() << " found" << std::endl;
+            
+            for (size_t i = 0; i < dids.size(); ++i) {
+                auto it = devices.find(dids[i]);
+                (*promises)[i].set_value(it != devices.end() ? it->second : CloudDeviceInfo());
+            }
+        });
+        
+        lock.lock();
     }
     
-    return CloudDeviceInfo();
+    // Release anyone still waiting
+    for (auto& pair : pending_lookups_) {
+        pair.second.promise.set_value(CloudDeviceInfo());
+    }
+    pending_lookups_.clear();
 }
 
 void MIoTCloudClient::set_access_token(const std::string& access_token) {
+    std::lock_guard<std::mutex> lock(token_mutex_);
     access_token_ = access_token;
 }
 
@@ -427,116 +352,489 @@ std::string SimpleJson::build_device_list_request(const std::vector<std::string>
     return oss.str();
 }
 
-std::string SimpleJson::extract_string(const std::string& json, const std::string& key) {
-    std::string search_key = "\"" + key + "\":\"";
-    size_t pos = json.find(search_key);
-    if (pos == std::string::npos) {
-        return "";
+namespace {
+
+/**
+ * Single-pass scanner for device_list_page responses.
+ *
+ * Walks the JSON once and fills CloudDeviceInfo directly: every object in the
+ * first "list" array is a device, including its "extra" and "owner" objects.
+ * Keys are compared in place; only string values that land in a field are
+ * copied (escapes are decoded then). Everything else is skipped.
+ */
+class DeviceListScanner {
+public:
+    DeviceListScanner(const std::string& json, std::map<std::string, CloudDeviceInfo>& devices)
+        : begin_(json.data()), p_(json.data()), end_(json.data() + json.size()), devices_(devices) {}
+    
+    bool run() {
+        if (!parse_object(Section::ROOT, nullptr)) {
+            return false;
+        }
+        skip_ws();
+        return p_ == end_ || fail("trailing data");
+    }
+    
+    bool found_list() const { return found_list_; }
+    size_t error_offset() const { return static_cast<size_t>(p_ - begin_); }
+    const char* error() const { return error_; }
+
+private:
+    enum class Section { ROOT, DEVICE, EXTRA, OWNER };
+    enum class Field {
+        NONE, DID, NAME, MODEL, URN, TOKEN, UID, ONLINE, LOCAL_IP, SSID, BSSID, RSSI,
+        FW_VERSION, MCU_VERSION, PLATFORM, IS_SET_PINCODE, PINCODE_TYPE,
+        OWNER_ID, OWNER_NICKNAME
+    };
+    
+    struct FieldName {
+        const char* name;
+        size_t len;
+        Field field;
+    };
+    
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    const char* error_ = nullptr;
+    std::map<std::string, CloudDeviceInfo>& devices_;
+    bool found_list_ = false;
+    static constexpr int MAX_DEPTH = 64;
+    int depth_ = 0;
+    
+    bool fail(const char* message) {
+        if (!error_) {
+            error_ = message;
+        }
+        return false;
     }
     
-    pos += search_key.length();
-    size_t end_pos = json.find("\"", pos);
-    if (end_pos == std::string::npos) {
-        return "";
+    void skip_ws() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
     }
     
-    return json.substr(pos, end_pos - pos);
-}
-
-int SimpleJson::extract_int(const std::string& json, const std::string& key) {
-    std::string search_key = "\"" + key + "\":";
-    size_t pos = json.find(search_key);
-    if (pos == std::string::npos) {
-        return 0;
+    bool expect(char c) {
+        skip_ws();
+        if (p_ < end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return fail("unexpected character");
+    }
+    
+    static Field lookup(Section section, const char* key, size_t len) {
+        static constexpr FieldName device_fields[] = {
+            {"did", 3, Field::DID}, {"name", 4, Field::NAME}, {"model", 5, Field::MODEL},
+            {"spec_type", 9, Field::URN}, {"token", 5, Field::TOKEN}, {"uid", 3, Field::UID},
+            {"isOnline", 8, Field::ONLINE}, {"local_ip", 8, Field::LOCAL_IP}, {"ssid", 4, Field::SSID},
+            {"bssid", 5, Field::BSSID}, {"rssi", 4, Field::RSSI},
+        };
+        static constexpr FieldName extra_fields[] = {
+            {"fw_version", 10, Field::FW_VERSION}, {"mcu_version", 11, Field::MCU_VERSION},
+            {"platform", 8, Field::PLATFORM}, {"isSetPincode", 12, Field::IS_SET_PINCODE},
+            {"pincodeType", 11, Field::PINCODE_TYPE},
+        };
+        static constexpr FieldName owner_fields[] = {
+            {"userid", 6, Field::OWNER_ID}, {"nickname", 8, Field::OWNER_NICKNAME},
+        };
+        
+        auto find = [key, len](const auto& table) {
+            for (const auto& entry : table) {
+                if (entry.len == len && std::memcmp(entry.name, key, len) == 0) {
+                    return entry.field;
+                }
+            }
+            return Field::NONE;
+        };
+        
+        switch (section) {
+            case Section::DEVICE: return find(device_fields);
+            case Section::EXTRA: return find(extra_fields);
+            case Section::OWNER: return find(owner_fields);
+            default: return Field::NONE;
+        }
     }
     
-    pos += search_key.length();
-    size_t end_pos = pos;
-    while (end_pos < json.length() && (std::isdigit(json[end_pos]) || json[end_pos] == '-')) {
-        end_pos++;
+    static std::string* string_field(CloudDeviceInfo& info, Field field) {
+        switch (field) {
+            case Field::DID: return &info.did;
+            case Field::NAME: return &info.name;
+            case Field::MODEL: return &info.model;
+            case Field::URN: return &info.urn;
+            case Field::TOKEN: return &info.token;
+            case Field::UID: return &info.uid;
+            case Field::LOCAL_IP: return &info.local_ip;
+            case Field::SSID: return &info.ssid;
+            case Field::BSSID: return &info.bssid;
+            case Field::FW_VERSION: return &info.fw_version;
+            case Field::MCU_VERSION: return &info.mcu_version;
+            case Field::PLATFORM: return &info.platform;
+            case Field::OWNER_ID: return &info.owner_id;
+            case Field::OWNER_NICKNAME: return &info.owner_nickname;
+            default: return nullptr;
+        }
     }
     
-    if (end_pos == pos) {
-        return 0;
+    static void append_utf8(std::string& out, uint32_t cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
     }
     
-    try {
-        return std::stoi(json.substr(pos, end_pos - pos));
-    } catch (...) {
-        return 0;
+    bool read_hex4(uint32_t& value) {
+        if (end_ - p_ < 4) {
+            return fail("truncated \\u escape");
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p_++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return fail("invalid \\u escape");
+        }
+        return true;
     }
-}
-
-bool SimpleJson::extract_bool(const std::string& json, const std::string& key) {
-    std::string search_key = "\"" + key + "\":";
-    size_t pos = json.find(search_key);
-    if (pos == std::string::npos) {
-        return false;
+    
+    /**
+     * Scan a string starting at the opening quote. [raw, raw_len) is the
+     * undecoded content; if out is given it receives the decoded value.
+     */
+    bool scan_string(const char*& raw, size_t& raw_len, std::string* out) {
+        skip_ws();
+        if (p_ >= end_ || *p_ != '"') {
+            return fail("expected string");
+        }
+        raw = ++p_;
+        
+        // Fast path: no escapes, find the closing quote directly
+        while (true) {
+            const void* hit = std::memchr(p_, '"', end_ - p_);
+            const char* quote = static_cast<const char*>(hit);
+            if (!quote) {
+                return fail("unterminated string");
+            }
+            const char* backslash = static_cast<const char*>(std::memchr(p_, '\\', quote - p_));
+            if (!backslash) {
+                p_ = quote + 1;
+                raw_len = static_cast<size_t>(quote - raw);
+                if (out) {
+                    out->assign(raw, raw_len);
+                }
+                return true;
+            }
+            
+            // Escapes present: decode from here on
+            std::string decoded(raw, backslash);
+            p_ = backslash;
+            while (p_ < end_ && *p_ != '"') {
+                if (*p_ != '\\') {
+                    decoded += *p_++;
+                    continue;
+                }
+                if (++p_ >= end_) {
+                    return fail("unterminated string");
+                }
+                char c = *p_++;
+                switch (c) {
+                    case '"': decoded += '"'; break;
+                    case '\\': decoded += '\\'; break;
+                    case '/': decoded += '/'; break;
+                    case 'b': decoded += '\b'; break;
+                    case 'f': decoded += '\f'; break;
+                    case 'n': decoded += '\n'; break;
+                    case 'r': decoded += '\r'; break;
+                    case 't': decoded += '\t'; break;
+                    case 'u': {
+                        uint32_t cp = 0;
+                        if (!read_hex4(cp)) {
+                            return false;
+                        }
+                        // Surrogate pair
+                        if (cp >= 0xD800 && cp <= 0xDBFF && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+                            p_ += 2;
+                            uint32_t low = 0;
+                            if (!read_hex4(low)) {
+                                return false;
+                            }
+                            if (low >= 0xDC00 && low <= 0xDFFF) {
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            } else {
+                                append_utf8(decoded, cp);
+                                cp = low;
+                            }
+                        }
+                        append_utf8(decoded, cp);
+                        break;
+                    }
+                    default:
+                        return fail("invalid escape");
+                }
+            }
+            if (p_ >= end_) {
+                return fail("unterminated string");
+            }
+            raw_len = static_cast<size_t>(p_ - raw);
+            ++p_;
+            if (out) {
+                *out = std::move(decoded);
+            }
+            return true;
+        }
     }
     
-    pos += search_key.length();
-    return json.substr(pos, 4) == "true";
-}
-
-std::map<std::string, CloudDeviceInfo> SimpleJson::parse_device_list_response(const std::string& json) {
-    std::map<std::string, CloudDeviceInfo> devices;
+    bool scan_literal(const char* word, size_t len) {
+        if (static_cast<size_t>(end_ - p_) < len || std::memcmp(p_, word, len) != 0) {
+            return fail("invalid literal");
+        }
+        p_ += len;
+        return true;
+    }
     
-    // Find the "list" array
-    size_t list_pos = json.find("\"list\":[");
-    if (list_pos == std::string::npos) {
-        std::cerr << "[SimpleJson] No 'list' found in response" << std::endl;
-        return devices;
+    bool scan_number(int64_t& value) {
+        const char* start = p_;
+        bool negative = false;
+        if (p_ < end_ && *p_ == '-') {
+            negative = true;
+            ++p_;
+        }
+        int64_t integer = 0;
+        const char* digits = p_;
+        while (p_ < end_ && *p_ >= '0' && *p_ <= '9') {
+            integer = integer * 10 + (*p_++ - '0');
+        }
+        if (p_ == digits) {
+            p_ = start;
+            return fail("invalid number");
+        }
+        // Fraction/exponent are accepted and truncated
+        if (p_ < end_ && *p_ == '.') {
+            ++p_;
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            ++p_;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) ++p_;
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        }
+        value = negative ? -integer : integer;
+        return true;
+    }
+    
+    /**
+     * Parse one value. info/field select where a scalar goes (may be null/NONE);
+     * objects and arrays here never belong to a device field.
+     */
+    bool parse_value(CloudDeviceInfo* info, Field field, bool is_list) {
+        skip_ws();
+        if (p_ >= end_) {
+            return fail("unexpected end of input");
+        }
+        
+        switch (*p_) {
+            case '{':
+                return parse_object(Section::ROOT, nullptr);
+            case '[':
+                return parse_array(is_list);
+            case '"': {
+                const char* raw = nullptr;
+                size_t raw_len = 0;
+                std::string* target = info ? string_field(*info, field) : nullptr;
+                return scan_string(raw, raw_len, target);
+            }
+            case 't':
+            case 'f': {
+                bool truthy = *p_ == 't';
+                if (!scan_literal(truthy ? "true" : "false", truthy ? 4 : 5)) {
+                    return false;
+                }
+                if (info) {
+                    set_number(*info, field, truthy ? 1 : 0);
+                }
+                return true;
+            }
+            case 'n':
+                return scan_literal("null", 4);
+            default: {
+                int64_t value = 0;
+                if (!scan_number(value)) {
+                    return false;
+                }
+                if (info) {
+                    set_number(*info, field, value);
+                }
+                return true;
+            }
+        }
     }
     
-    size_t pos = list_pos + 8;  // Skip "\"list\":["
+    static void set_number(CloudDeviceInfo& info, Field field, int64_t value) {
+        switch (field) {
+            case Field::ONLINE: info.online = value != 0; break;
+            case Field::RSSI: info.rssi = static_cast<int>(value); break;
+            case Field::IS_SET_PINCODE: info.is_set_pincode = static_cast<int>(value); break;
+            case Field::PINCODE_TYPE: info.pincode_type = static_cast<int>(value); break;
+            default:
+                // Numeric IDs (uid, owner userid, did) are kept as strings
+                if (std::string* target = string_field(info, field)) {
+                    *target = std::to_string(value);
+                }
+                break;
+        }
+    }
     
-    // Parse each device object
-    while (pos < json.length()) {
-        // Find next device object
-        size_t obj_start = json.find("{", pos);
-        if (obj_start == std::string::npos) {
-            break;
+    bool parse_object(Section section, CloudDeviceInfo* info) {
+        if (!expect('{')) {
+            return false;
         }
-        
-        // Find matching closing brace
-        int brace_count = 1;
-        size_t obj_end = obj_start + 1;
-        while (obj_end < json.length() && brace_count > 0) {
-            if (json[obj_end] == '{') brace_count++;
-            else if (json[obj_end] == '}') brace_count--;
-            obj_end++;
+        if (++depth_ > MAX_DEPTH) {
+            return fail("nesting too deep");
         }
         
-        if (brace_count != 0) {
-            break;
+        skip_ws();
+        if (p_ < end_ && *p_ == '}') {
+            ++p_;
+            --depth_;
+            return true;
         }
         
-        std::string device_json = json.substr(obj_start, obj_end - obj_start);
+        while (true) {
+            const char* key = nullptr;
+            size_t key_len = 0;
+            if (!scan_string(key, key_len, nullptr) || !expect(':')) {
+                return false;
+            }
+            skip_ws();
+            
+            bool ok;
+            if (section == Section::DEVICE && p_ < end_ && *p_ == '{' &&
+                key_len == 5 && std::memcmp(key, "extra", 5) == 0) {
+                ok = parse_object(Section::EXTRA, info);
+            } else if (section == Section::DEVICE && p_ < end_ && *p_ == '{' &&
+                       key_len == 5 && std::memcmp(key, "owner", 5) == 0) {
+                ok = parse_object(Section::OWNER, info);
+            } else if (section == Section::DEVICE || section == Section::EXTRA || section == Section::OWNER) {
+                Field field = lookup(section, key, key_len);
+                ok = field != Field::NONE ? parse_value(info, field, false)
+                                          : skip_value();
+            } else {
+                // Outside the device list: descend into objects looking for "list"
+                bool is_list = !found_list_ && key_len == 4 && std::memcmp(key, "list", 4) == 0;
+                ok = parse_value(nullptr, Field::NONE, is_list);
+            }
+            if (!ok) {
+                return false;
+            }
+            
+            skip_ws();
+            if (p_ < end_ && *p_ == ',') {
+                ++p_;
+                continue;
+            }
+            if (!expect('}')) {
+                return false;
+            }
+            --depth_;
+            return true;
+        }
+    }
+    
+    bool parse_array(bool is_list) {
+        if (!expect('[')) {
+            return false;
+        }
+        if (++depth_ > MAX_DEPTH) {
+            return fail("nesting too deep");
+        }
+        if (is_list) {
+            found_list_ = true;
+        }
         
-        CloudDeviceInfo info;
-        info.did = extract_string(device_json, "did");
-        info.name = extract_string(device_json, "name");
-        info.model = extract_string(device_json, "model");
-        info.urn = extract_string(device_json, "spec_type");
-        info.token = extract_string(device_json, "token");
-        info.uid = extract_string(device_json, "uid");
-        info.online = extract_bool(device_json, "isOnline");
-        info.local_ip = extract_string(device_json, "local_ip");
-        info.ssid = extract_string(device_json, "ssid");
-        info.bssid = extract_string(device_json, "bssid");
-        info.rssi = extract_int(device_json, "rssi");
+        skip_ws();
+        if (p_ < end_ && *p_ == ']') {
+            ++p_;
+            --depth_;
+            return true;
+        }
         
-        if (!info.did.empty() && !info.model.empty()) {
-            // Extract manufacturer from model (e.g., "xiaomi.camera.082ac1" -> "xiaomi")
-            size_t dot_pos = info.model.find('.');
-            if (dot_pos != std::string::npos) {
-                info.manufacturer = info.model.substr(0, dot_pos);
+        while (true) {
+            skip_ws();
+            bool ok;
+            if (is_list && p_ < end_ && *p_ == '{') {
+                CloudDeviceInfo info;
+                ok = parse_object(Section::DEVICE, &info);
+                if (ok) {
+                    finish_device(info);
+                }
+            } else {
+                ok = skip_value();
+            }
+            if (!ok) {
+                return false;
             }
             
-            devices[info.did] = info;
+            skip_ws();
+            if (p_ < end_ && *p_ == ',') {
+                ++p_;
+                continue;
+            }
+            if (!expect(']')) {
+                return false;
+            }
+            --depth_;
+            return true;
+        }
+    }
+    
+    // Values we don't need are still validated
+    bool skip_value() {
+        return parse_value(nullptr, Field::NONE, false);
+    }
+    
+    void finish_device(CloudDeviceInfo& info) {
+        if (info.did.empty() || info.model.empty()) {
+            return;
+        }
+        
+        // Extract manufacturer from model (e.g., "xiaomi.camera.082ac1" -> "xiaomi")
+        size_t dot_pos = info.model.find('.');
+        if (dot_pos != std::string::npos) {
+            info.manufacturer = info.model.substr(0, dot_pos);
         }
         
-        pos = obj_end;
+        std::string did = info.did;
+        devices_[std::move(did)] = std::move(info);
+    }
+};
+
+} // anonymous namespace
+
+std::map<std::string, CloudDeviceInfo> SimpleJson::parse_device_list_response(const std::string& json) {
+    std::map<std::string, CloudDeviceInfo> devices;
+    
+    DeviceListScanner scanner(json, devices);
+    if (!scanner.run()) {
+        std::cerr << "[SimpleJson] Parse error at " << scanner.error_offset() << ": " 
+                  << (scanner.error() ? scanner.error() : "invalid JSON") << std::endl;
+    }
+    
+    if (!scanner.found_list()) {
+        std::cerr << "[SimpleJson] No 'list' found in response" << std::endl;
     }
     
     return devices;
@@ -6,12 +6,15 @@
  */
 
 #include "miot_lan_device.h"
+#include "device_registry.h"
+#include "timer_wheel.h"
 
 #include <iostream>
 #include <cstring>
 #include <ctime>
 #include <random>
 #include <algorithm>
+#include <cstdlib>
 
 // Platform-specific includes
 #ifdef _WIN32
@@ -32,6 +35,13 @@
     #include <fcntl.h>
     #include <errno.h>
     #include <ifaddrs.h>
+    #ifdef __linux__
+        #include <sys/epoll.h>
+        #include <sys/timerfd.h>
+        #include <sys/eventfd.h>
+        #include <linux/netlink.h>
+        #include <linux/rtnetlink.h>
+    #endif
     #define SOCKET_ERROR_CODE errno
     #define CLOSE_SOCKET close
 #endif
@@ -80,6 +90,19 @@ uint32_t read_uint32_be(const uint8_t* buf) {
            (uint32_t)buf[3];
 }
 
+// Parse a decimal DID
+bool parse_did(const std::string& did, uint64_t& value) {
+    char* end = nullptr;
+    value = std::strtoull(did.c_str(), &end, 10);
+    return !did.empty() && *end == '\0';
+}
+
+// Seconds to a steady clock duration
+std::chrono::steady_clock::duration to_duration(double seconds) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(seconds));
+}
+
 // Get current Unix timestamp
 int64_t get_current_timestamp() {
     return std::chrono::duration_cast<std::chrono::seconds>(
@@ -93,11 +116,23 @@ MIoTLanDiscovery::MIoTLanDiscovery(
     const std::vector<std::string>& interfaces,
     uint64_t virtual_did
 ) : interfaces_(interfaces),
+    auto_interfaces_(interfaces.empty()),
     virtual_did_(virtual_did ? virtual_did : generate_random_did()),
     running_(false),
+    epoll_fd_(-1),
+    timer_fd_(-1),
+    wake_fd_(-1),
+    device_timer_fd_(-1),
+    netlink_fd_(-1),
+    devices_(std::make_unique<DeviceRegistry>()),
+    liveness_wheel_(std::make_unique<TimerWheel>(std::chrono::milliseconds(100), std::chrono::steady_clock::now())),
+    probe_wheel_(std::make_unique<TimerWheel>(std::chrono::milliseconds(100), std::chrono::steady_clock::now())),
     min_scan_interval_(5.0),
     max_scan_interval_(45.0),
     current_scan_interval_(5.0),
+    scan_reset_pending_(false),
+    keepalive_interval_(30.0),
+    min_keepalive_interval_(2.0),
     device_timeout_(600.0)
 {
 #ifdef _WIN32
@@ -158,58 +193,54 @@ bool MIoTLanDiscovery::start() {
         return false;
     }
     
-    // Get available network interfaces if not specified
-    if (interfaces_.empty()) {
-#ifndef _WIN32
-        struct ifaddrs* ifaddr = nullptr;
-        if (getifaddrs(&ifaddr) == 0) {
-            for (struct ifaddrs* ifa = ifaddr; ifa != nullptr; ifa = ifa->ifa_next) {
-                if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET) {
-                    // Skip loopback
-                    if (!(ifa->ifa_flags & IFF_LOOPBACK)) {
-                        interfaces_.push_back(ifa->ifa_name);
-                    }
-                }
-            }
-            freeifaddrs(ifaddr);
-        }
-#else
-        // On Windows, use default interface
-        interfaces_.push_back("");
-#endif
-    }
+    std::set<std::string> interfaces = find_interfaces();
     
-    if (interfaces_.empty()) {
+    if (interfaces.empty()) {
+#ifdef __linux__
+        // Links that come up later are picked up from netlink
+        std::cout << "[MIoTLanDiscovery] No network interfaces yet, waiting for links" << std::endl;
+#else
         std::cerr << "[MIoTLanDiscovery] No network interfaces found" << std::endl;
         return false;
+#endif
+    } else {
+        std::cout << "[MIoTLanDiscovery] Using interfaces: ";
+        for (const auto& iface : interfaces) {
+            std::cout << iface << " ";
+        }
+        std::cout << std::endl;
     }
     
-    std::cout << "[MIoTLanDiscovery] Using interfaces: ";
-    for (const auto& iface : interfaces_) {
-        std::cout << iface << " ";
-    }
-    std::cout << std::endl;
-    
     // Create sockets for each interface
-    for (const auto& iface : interfaces_) {
+    for (const auto& iface : interfaces) {
         if (!create_socket(iface)) {
             std::cerr << "[MIoTLanDiscovery] Failed to create socket for interface: " 
                       << iface << std::endl;
         }
     }
     
+#ifndef __linux__
     if (sockets_.empty()) {
         std::cerr << "[MIoTLanDiscovery] No sockets created" << std::endl;
         return false;
     }
+#endif
+    
+    if (!init_event_loop()) {
+        close_all_sockets();
+        return false;
+    }
     
     running_ = true;
+    event_dispatcher_.start();
     
     // Start discovery thread
     discovery_thread_ = std::thread([this]() { discovery_loop(); });
     
-    // Start timeout checker thread
+#ifndef __linux__
+    // Start timeout checker thread (on Linux the event loop owns the liveness timer)
     timeout_checker_thread_ = std::thread([this]() { timeout_checker_loop(); });
+#endif
     
     std::cout << "[MIoTLanDiscovery] Started" << std::endl;
     return true;
@@ -222,6 +253,14 @@ void MIoTLanDiscovery::stop() {
     
     running_ = false;
     
+#ifdef __linux__
+    // Wake the event loop so it sees running_ == false
+    uint64_t one = 1;
+    if (write(wake_fd_, &one, sizeof(one)) < 0) {
+        std::cerr << "[MIoTLanDiscovery] Failed to wake event loop: " << errno << std::endl;
+    }
+#endif
+    
     // Wait for threads to finish
     if (discovery_thread_.joinable()) {
         discovery_thread_.join();
@@ -231,6 +270,10 @@ void MIoTLanDiscovery::stop() {
     }
     
     close_all_sockets();
+    close_event_loop();
+    
+    // Deliver events that were already queued
+    event_dispatcher_.stop();
     
     std::cout << "[MIoTLanDiscovery] Stopped" << std::endl;
 }
@@ -310,6 +353,44 @@ bool MIoTLanDiscovery::create_socket(const std::string& interface_name) {
     return true;
 }
 
+std::set<std::string> MIoTLanDiscovery::find_interfaces() const {
+    std::set<std::string> result;
+    
+#ifndef _WIN32
+    if (!auto_interfaces_) {
+        // Given names, as long as the interface exists
+        for (const auto& iface : interfaces_) {
+            if (iface.empty() || if_nametoindex(iface.c_str()) != 0) {
+                result.insert(iface);
+            }
+        }
+        return result;
+    }
+    
+    struct ifaddrs* ifaddr = nullptr;
+    if (getifaddrs(&ifaddr) == 0) {
+        for (struct ifaddrs* ifa = ifaddr; ifa != nullptr; ifa = ifa->ifa_next) {
+            if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET) {
+                // Skip loopback and interfaces that are down
+                if (!(ifa->ifa_flags & IFF_LOOPBACK) && (ifa->ifa_flags & IFF_UP)) {
+                    result.insert(ifa->ifa_name);
+                }
+            }
+        }
+        freeifaddrs(ifaddr);
+    }
+#else
+    if (!auto_interfaces_) {
+        result.insert(interfaces_.begin(), interfaces_.end());
+    } else {
+        // On Windows, use default interface
+        result.insert("");
+    }
+#endif
+    
+    return result;
+}
+
 void MIoTLanDiscovery::close_all_sockets() {
     std::lock_guard<std::mutex> lock(sockets_mutex_);
     for (auto& pair : sockets_) {
@@ -318,12 +399,383 @@ void MIoTLanDiscovery::close_all_sockets() {
     sockets_.clear();
 }
 
+#ifdef __linux__
+/**
+ * Preallocated receive slots for recvmmsg, reused across wakeups
+ */
+struct MIoTLanDiscovery::RecvBatch {
+    uint8_t buffers[RECV_BATCH][OT_MSG_LEN];
+    struct iovec iovecs[RECV_BATCH];
+    struct sockaddr_in addrs[RECV_BATCH];
+    struct mmsghdr msgs[RECV_BATCH];
+    
+    RecvBatch() {
+        std::memset(msgs, 0, sizeof(msgs));
+        for (size_t i = 0; i < RECV_BATCH; i++) {
+            iovecs[i].iov_base = buffers[i];
+            iovecs[i].iov_len = OT_MSG_LEN;
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+        }
+    }
+};
+#endif
+
+bool MIoTLanDiscovery::init_event_loop() {
+#ifdef __linux__
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    device_timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epoll_fd_ < 0 || timer_fd_ < 0 || wake_fd_ < 0 || device_timer_fd_ < 0) {
+        std::cerr << "[MIoTLanDiscovery] Failed to create event loop: " 
+                  << SOCKET_ERROR_CODE << std::endl;
+        close_event_loop();
+        return false;
+    }
+    
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    
+    ev.data.fd = timer_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &ev);
+    ev.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+    ev.data.fd = device_timer_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, device_timer_fd_, &ev);
+    
+    // Without netlink the interface set stays as it was at start
+    if (open_netlink()) {
+        ev.data.fd = netlink_fd_;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, netlink_fd_, &ev);
+    }
+    
+    std::lock_guard<std::mutex> lock(sockets_mutex_);
+    for (const auto& pair : sockets_) {
+        ev.data.fd = pair.second.fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, pair.second.fd, &ev) < 0) {
+            std::cerr << "[MIoTLanDiscovery] Failed to watch socket for interface " 
+                      << pair.first << ": " << SOCKET_ERROR_CODE << std::endl;
+        }
+    }
+#endif
+    return true;
+}
+
+void MIoTLanDiscovery::close_event_loop() {
+#ifdef __linux__
+    for (int* fd : {&epoll_fd_, &timer_fd_, &wake_fd_, &device_timer_fd_, &netlink_fd_}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+#endif
+}
+
+bool MIoTLanDiscovery::open_netlink() {
+#ifdef __linux__
+    netlink_fd_ = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (netlink_fd_ < 0) {
+        std::cerr << "[MIoTLanDiscovery] Failed to open netlink socket: " << SOCKET_ERROR_CODE << std::endl;
+        return false;
+    }
+    
+    struct sockaddr_nl addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+    
+    if (bind(netlink_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "[MIoTLanDiscovery] Failed to bind netlink socket: " << SOCKET_ERROR_CODE << std::endl;
+        close(netlink_fd_);
+        netlink_fd_ = -1;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MIoTLanDiscovery::drain_netlink() {
+#ifdef __linux__
+    // Only whether links or addresses changed matters, the new state is re-read with getifaddrs
+    bool changed = false;
+    alignas(struct nlmsghdr) char buffer[8192];
+    
+    while (true) {
+        ssize_t len = recv(netlink_fd_, buffer, sizeof(buffer), 0);
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOBUFS) {
+                // Overrun, some notifications were lost
+                changed = true;
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "[MIoTLanDiscovery] netlink recv failed: " << SOCKET_ERROR_CODE << std::endl;
+            }
+            return changed;
+        }
+        
+        int remaining = static_cast<int>(len);
+        for (struct nlmsghdr* msg = reinterpret_cast<struct nlmsghdr*>(buffer);
+             NLMSG_OK(msg, remaining);
+             msg = NLMSG_NEXT(msg, remaining)) {
+            switch (msg->nlmsg_type) {
+                case RTM_NEWLINK:
+                case RTM_DELLINK:
+                case RTM_NEWADDR:
+                case RTM_DELADDR:
+                    changed = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+#else
+    return false;
+#endif
+}
+
+void MIoTLanDiscovery::sync_interfaces() {
+#ifdef __linux__
+    std::set<std::string> wanted = find_interfaces();
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    
+    {
+        std::lock_guard<std::mutex> lock(sockets_mutex_);
+        for (auto it = sockets_.begin(); it != sockets_.end();) {
+            if (wanted.count(it->first)) {
+                ++it;
+                continue;
+            }
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+            CLOSE_SOCKET(it->second.fd);
+            removed.push_back(it->first);
+            it = sockets_.erase(it);
+        }
+    }
+    
+    for (const auto& iface : wanted) {
+        {
+            std::lock_guard<std::mutex> lock(sockets_mutex_);
+            if (sockets_.count(iface)) {
+                continue;
+            }
+        }
+        if (!create_socket(iface)) {
+            continue;
+        }
+        
+        std::lock_guard<std::mutex> lock(sockets_mutex_);
+        struct epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = sockets_[iface].fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, ev.data.fd, &ev) < 0) {
+            std::cerr << "[MIoTLanDiscovery] Failed to watch socket for interface " 
+                      << iface << ": " << SOCKET_ERROR_CODE << std::endl;
+        }
+        added.push_back(iface);
+    }
+    
+    for (const auto& iface : removed) {
+        std::cout << "[MIoTLanDiscovery] Interface gone: " << iface << std::endl;
+    }
+    
+    for (const auto& iface : added) {
+        std::cout << "[MIoTLanDiscovery] Interface up: " << iface << std::endl;
+        
+        // Probe burst: devices last seen on this link by unicast, the rest by broadcast below
+        for (const auto& device : *devices_->snapshot()) {
+            if (device.interface == iface && !device.ip.empty()) {
+                send_probe(iface, device.ip);
+            }
+        }
+    }
+    
+    if (!added.empty() || !removed.empty()) {
+        notify_network_changed();
+    }
+#endif
+}
+
+void MIoTLanDiscovery::arm_probe_timer(double seconds) {
+#ifdef __linux__
+    // One-shot; re-armed after each probe with the next backoff interval
+    int64_t ns = static_cast<int64_t>(seconds * 1e9);
+    if (ns <= 0) {
+        ns = 1;  // A zero it_value would disarm the timer
+    }
+    
+    struct itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+    timerfd_settime(timer_fd_, 0, &spec, nullptr);
+#else
+    (void)seconds;
+#endif
+}
+
+void MIoTLanDiscovery::arm_device_timer() {
+#ifdef __linux__
+    // Absolute CLOCK_MONOTONIC time, which is what steady_clock reads on Linux
+    struct itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    
+    std::chrono::steady_clock::time_point wakeup;
+    std::chrono::steady_clock::time_point probe_wakeup;
+    bool armed = liveness_wheel_->next_wakeup(wakeup);
+    if (probe_wheel_->next_wakeup(probe_wakeup) && (!armed || probe_wakeup < wakeup)) {
+        wakeup = probe_wakeup;
+        armed = true;
+    }
+    if (armed) {
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeup.time_since_epoch()).count();
+        if (ns <= 0) {
+            ns = 1;  // A zero it_value would disarm the timer
+        }
+        spec.it_value.tv_sec = ns / 1000000000;
+        spec.it_value.tv_nsec = ns % 1000000000;
+    }
+    timerfd_settime(device_timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+#endif
+}
+
+void MIoTLanDiscovery::drain_socket(const SocketInfo& socket_info, RecvBatch& batch) {
+#ifdef __linux__
+    // Level-triggered epoll: stop at EAGAIN or a short batch, anything left re-arms the fd
+    while (running_) {
+        for (size_t i = 0; i < RECV_BATCH; i++) {
+            batch.msgs[i].msg_hdr.msg_namelen = sizeof(batch.addrs[i]);
+        }
+        
+        int count = recvmmsg(socket_info.fd, batch.msgs, RECV_BATCH, MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "[MIoTLanDiscovery] recvmmsg failed on interface " 
+                          << socket_info.interface << ": " << SOCKET_ERROR_CODE << std::endl;
+            }
+            return;
+        }
+        
+        for (int i = 0; i < count; i++) {
+            // Check if from OT port
+            if (batch.addrs[i].sin_port != htons(OT_PORT)) {
+                continue;
+            }
+            
+            handle_received_data(
+                batch.buffers[i],
+                batch.msgs[i].msg_len,
+                batch.addrs[i].sin_addr.s_addr,
+                socket_info.interface
+            );
+        }
+        
+        if (static_cast<size_t>(count) < RECV_BATCH) {
+            return;
+        }
+    }
+#else
+    (void)socket_info;
+    (void)batch;
+#endif
+}
+
 void MIoTLanDiscovery::discovery_loop() {
     std::cout << "[MIoTLanDiscovery] Discovery loop started" << std::endl;
     
+#ifdef __linux__
+    // Initial random delay (0-3 seconds)
+    arm_probe_timer((rand() % 3000) / 1000.0);
+    
+    auto batch = std::make_unique<RecvBatch>();
+    struct epoll_event events[16];
+    
+    // Catch link changes between the enumeration in start() and the netlink subscription
+    sync_interfaces();
+    
+    while (running_) {
+        int ready = epoll_wait(epoll_fd_, events, 16, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "[MIoTLanDiscovery] epoll_wait failed: " << SOCKET_ERROR_CODE << std::endl;
+            break;
+        }
+        
+        for (int i = 0; i < ready && running_; i++) {
+            int fd = events[i].data.fd;
+            uint64_t counter;
+            
+            if (fd == wake_fd_) {
+                // Only used to interrupt epoll_wait, running_ is checked by the loop
+                ssize_t drained = read(wake_fd_, &counter, sizeof(counter));
+                (void)drained;
+                continue;
+            }
+            
+            if (fd == timer_fd_) {
+                if (read(timer_fd_, &counter, sizeof(counter)) > 0) {
+                    // Send probe message and schedule the next scan
+                    send_probe();
+                    arm_probe_timer(get_next_scan_interval());
+                }
+                continue;
+            }
+            
+            if (fd == netlink_fd_) {
+                if (drain_netlink()) {
+                    sync_interfaces();
+                }
+                continue;
+            }
+            
+            if (fd == device_timer_fd_) {
+                if (read(device_timer_fd_, &counter, sizeof(counter)) > 0) {
+                    check_device_timeouts();
+                    send_keepalive_probes();
+                }
+                continue;
+            }
+            
+            SocketInfo socket_info{-1, ""};
+            {
+                std::lock_guard<std::mutex> lock(sockets_mutex_);
+                for (const auto& pair : sockets_) {
+                    if (pair.second.fd == fd) {
+                        socket_info = pair.second;
+                        break;
+                    }
+                }
+            }
+            
+            // Sockets are only closed on this thread (sync_interfaces) or after it has been joined
+            if (socket_info.fd >= 0) {
+                drain_socket(socket_info, *batch);
+            }
+        }
+    }
+#else
     // Initial random delay (0-3 seconds)
     std::this_thread::sleep_for(std::chrono::milliseconds(rand() % 3000));
     
+    std::vector<uint8_t> buffer(OT_MSG_LEN);
+    
     while (running_) {
         // Send probe message
         send_probe();
@@ -334,12 +786,11 @@ void MIoTLanDiscovery::discovery_loop() {
         
         while (running_) {
             // Check for received data
-            std::vector<uint8_t> buffer(OT_MSG_LEN);
             struct sockaddr_in from_addr;
-            socklen_t from_len = sizeof(from_addr);
             
             std::lock_guard<std::mutex> lock(sockets_mutex_);
             for (const auto& pair : sockets_) {
+                socklen_t from_len = sizeof(from_addr);
                 ssize_t recv_len = recvfrom(
                     pair.second.fd, 
                     reinterpret_cast<char*>(buffer.data()), 
@@ -351,13 +802,11 @@ void MIoTLanDiscovery::discovery_loop() {
                 
                 if (recv_len > 0) {
                     // Check if from OT port
-                    if (ntohs(from_addr.sin_port) == OT_PORT) {
-                        char from_ip[INET_ADDRSTRLEN];
-                        inet_ntop(AF_INET, &from_addr.sin_addr, from_ip, INET_ADDRSTRLEN);
+                    if (from_addr.sin_port == htons(OT_PORT)) {
                         handle_received_data(
                             buffer.data(), 
                             recv_len, 
-                            from_ip, 
+                            from_addr.sin_addr.s_addr, 
                             pair.second.interface
                         );
                     }
@@ -369,7 +818,7 @@ void MIoTLanDiscovery::discovery_loop() {
                 std::chrono::steady_clock::now() - start
             ).count();
             
-            if (elapsed >= scan_interval) {
+            if (elapsed >= scan_interval || scan_reset_pending_) {
                 break;
             }
             
@@ -378,15 +827,19 @@ void MIoTLanDiscovery::discovery_loop() {
         }
     }
     
+#endif
+    
     std::cout << "[MIoTLanDiscovery] Discovery loop stopped" << std::endl;
 }
 
 void MIoTLanDiscovery::timeout_checker_loop() {
     std::cout << "[MIoTLanDiscovery] Timeout checker started" << std::endl;
     
+    // Only used without the Linux event loop; the wheels are advanced once a second
     while (running_) {
         check_device_timeouts();
-        std::this_thread::sleep_for(std::chrono::seconds(5));
+        send_keepalive_probes();
+        std::this_thread::sleep_for(std::chrono::seconds(1));
     }
     
     std::cout << "[MIoTLanDiscovery] Timeout checker stopped" << std::endl;
@@ -438,14 +891,19 @@ void MIoTLanDiscovery::ping(const std::string& interface_name, const std::string
     send_probe(interface_name, target_ip);
 }
 
+bool MIoTLanDiscovery::has_interface(const std::string& interface_name) const {
+    std::lock_guard<std::mutex> lock(sockets_mutex_);
+    return sockets_.count(interface_name) > 0;
+}
+
 void MIoTLanDiscovery::handle_received_data(
     const uint8_t* data, 
     size_t len, 
-    const std::string& from_ip,
+    uint32_t from_addr,
     const std::string& interface_name
 ) {
-    // Check minimum length
-    if (len < 16) {
+    // Only probe responses (32 bytes) are used
+    if (len != OT_PROBE_LEN) {
         return;
     }
     
@@ -455,104 +913,149 @@ void MIoTLanDiscovery::handle_received_data(
     }
     
     // Parse DID (bytes 4-11, big endian)
-    uint64_t did_num = read_uint64_be(&data[4]);
-    std::string did = std::to_string(did_num);
+    uint64_t did = read_uint64_be(&data[4]);
     
     // Parse timestamp (bytes 12-15, big endian)
     uint32_t device_timestamp = read_uint32_be(&data[12]);
     int64_t current_timestamp = get_current_timestamp();
     int64_t timestamp_offset = current_timestamp - device_timestamp;
     
-    // Check if this is a probe response (32 bytes)
-    if (len == OT_PROBE_LEN) {
-        update_device(did, from_ip, interface_name, timestamp_offset);
-    }
+    update_device(did, from_addr, interface_name, timestamp_offset);
 }
 
 void MIoTLanDiscovery::update_device(
-    const std::string& did,
-    const std::string& ip,
+    uint64_t did,
+    uint32_t ip_addr,
     const std::string& interface_name,
     int64_t timestamp_offset
 ) {
-    std::lock_guard<std::mutex> lock(devices_mutex_);
-    
-    auto it = devices_.find(did);
-    bool is_new = (it == devices_.end());
-    bool status_changed = false;
-    
-    if (is_new) {
-        // New device
-        auto device = std::make_shared<DeviceInfo>();
-        device->did = did;
-        device->ip = ip;
-        device->interface = interface_name;
-        device->online = true;
-        device->timestamp_offset = timestamp_offset;
-        device->last_seen = std::chrono::steady_clock::now();
-        device->status_changed_type = DeviceStatusChangedType::NEW;
-        
-        devices_[did] = device;
-        status_changed = true;
-    } else {
-        // Existing device
-        auto& device = it->second;
-        
-        if (!device->online) {
-            device->online = true;
-            status_changed = true;
-            device->status_changed_type = DeviceStatusChangedType::ONLINE;
+    DeviceInfo changed_info;
+    bool status_changed = devices_->update(
+        did, ip_addr, interface_name, timestamp_offset,
+        std::chrono::steady_clock::now(), changed_info
+    );
+    
+    // Notify outside the shard lock
+    if (status_changed) {
+        // New or back online: (re)start its offline timer
+        {
+            std::lock_guard<std::mutex> lock(device_timers_mutex_);
+            liveness_wheel_->schedule(did, changed_info.last_seen + device_timeout_for(did));
+            
+            // Known from now on: kept alive by unicast, on the relaxed schedule
+            probe_states_[did] = ProbeState{};
+            probe_wheel_->schedule(did, changed_info.last_seen + to_duration(keepalive_interval_));
+            arm_device_timer();
         }
         
-        if (device->ip != ip) {
-            device->ip = ip;
-            status_changed = true;
-            device->status_changed_type = DeviceStatusChangedType::IP_CHANGED;
+        // A device that moved suggests the network changed under us
+        if (changed_info.status_changed_type == DeviceStatusChangedType::IP_CHANGED ||
+            changed_info.status_changed_type == DeviceStatusChangedType::INTERFACE_CHANGED) {
+            notify_network_changed();
         }
         
-        if (device->interface != interface_name) {
-            device->interface = interface_name;
-            status_changed = true;
-            device->status_changed_type = DeviceStatusChangedType::INTERFACE_CHANGED;
+        notify_callbacks(changed_info.did, changed_info);
+    }
+}
+
+void MIoTLanDiscovery::check_device_timeouts() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<DeviceInfo> offline_devices;
+    
+    {
+        std::lock_guard<std::mutex> lock(device_timers_mutex_);
+        
+        std::vector<uint64_t> due;
+        liveness_wheel_->advance(now, due);
+        
+        for (uint64_t did : due) {
+            auto timeout = device_timeout_for(did);
+            DeviceInfo info;
+            if (devices_->expire_if_idle(did, now - timeout, info)) {
+                offline_devices.push_back(info);
+            } else if (info.online) {
+                // Seen since the timer was set, wait out the rest of its window
+                liveness_wheel_->schedule(did, info.last_seen + timeout);
+            }
         }
         
-        device->timestamp_offset = timestamp_offset;
-        device->last_seen = std::chrono::steady_clock::now();
+        arm_device_timer();
     }
     
-    if (status_changed) {
-        notify_callbacks(did, *devices_[did]);
+    for (const auto& info : offline_devices) {
+        std::cout << "[MIoTLanDiscovery] Device offline (timeout): " 
+                  << info.did << std::endl;
+        notify_callbacks(info.did, info);
     }
 }
 
-void MIoTLanDiscovery::check_device_timeouts() {
-    std::lock_guard<std::mutex> lock(devices_mutex_);
-    
+void MIoTLanDiscovery::send_keepalive_probes() {
     auto now = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::string, std::string>> targets;  // Interface, IP
     
-    for (auto& pair : devices_) {
-        auto& device = pair.second;
+    {
+        std::lock_guard<std::mutex> lock(device_timers_mutex_);
         
-        if (device->online) {
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                now - device->last_seen
-            ).count();
+        std::vector<uint64_t> due;
+        probe_wheel_->advance(now, due);
+        
+        auto keepalive = to_duration(keepalive_interval_);
+        for (uint64_t did : due) {
+            DeviceInfo info;
+            if (!devices_->find(did, info) || info.ip.empty()) {
+                continue;
+            }
+            
+            ProbeState& state = probe_states_[did];
+            
+            // Heard from recently (e.g. a broadcast reply): no keepalive needed yet
+            if (state.missed == 0 && info.last_seen > state.sent_at && info.last_seen + keepalive > now) {
+                probe_wheel_->schedule(did, info.last_seen + keepalive);
+                continue;
+            }
+            
+            // Silence since the previous keepalive halves the interval, down to the floor
+            if (state.sent_at != std::chrono::steady_clock::time_point() && info.last_seen < state.sent_at) {
+                state.missed++;
+            } else {
+                state.missed = 0;
+            }
+            state.sent_at = now;
             
-            if (elapsed >= device_timeout_) {
-                device->online = false;
-                device->status_changed_type = DeviceStatusChangedType::OFFLINE;
-                std::cout << "[MIoTLanDiscovery] Device offline (timeout): " 
-                          << device->did << std::endl;
-                notify_callbacks(device->did, *device);
+            double interval = keepalive_interval_;
+            if (state.missed > 0 && now - info.last_seen < to_duration(FAST_PROBE_WINDOW)) {
+                interval = std::max(min_keepalive_interval_, keepalive_interval_ / (1 << std::min(state.missed, 16)));
             }
+            probe_wheel_->schedule(did, now + to_duration(interval));
+            
+            targets.emplace_back(info.interface, info.ip);
         }
+        
+        arm_device_timer();
+    }
+    
+    for (const auto& target : targets) {
+        send_probe(target.first, target.second);
     }
 }
 
 void MIoTLanDiscovery::notify_callbacks(const std::string& did, const DeviceInfo& info) {
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    // Hand off to the dispatcher; events for one DID stay in order
+    if (!event_dispatcher_.post(did, [this, did, info]() { run_callbacks(did, info); })) {
+        std::cerr << "[MIoTLanDiscovery] Dropped event for " << did 
+                  << ": dispatcher not running" << std::endl;
+    }
+}
+
+void MIoTLanDiscovery::run_callbacks(const std::string& did, const DeviceInfo& info) {
+    // Copy so callbacks can (un)register without deadlocking
+    std::map<std::string, DeviceStatusCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(callbacks_mutex_);
+        callbacks = callbacks_;
+    }
     
-    for (const auto& pair : callbacks_) {
+    for (const auto& pair : callbacks) {
         try {
             pair.second(did, info);
         } catch (const std::exception& e) {
@@ -561,24 +1064,39 @@ void MIoTLanDiscovery::notify_callbacks(const std::string& did, const DeviceInfo
     }
 }
 
+DeviceEventStats MIoTLanDiscovery::get_event_stats() const {
+    return event_dispatcher_.get_stats();
+}
+
 std::map<std::string, DeviceInfo> MIoTLanDiscovery::get_devices() const {
-    std::lock_guard<std::mutex> lock(devices_mutex_);
-    
+    // Read the shards directly so last_seen agrees with get_device()
     std::map<std::string, DeviceInfo> result;
-    for (const auto& pair : devices_) {
-        result[pair.first] = *pair.second;
+    for (auto& device : devices_->collect()) {
+        std::string did = device.did;
+        result.emplace(std::move(did), std::move(device));
     }
     return result;
 }
 
+std::shared_ptr<const DeviceSnapshot> MIoTLanDiscovery::get_device_snapshot() const {
+    return devices_->snapshot();
+}
+
+size_t MIoTLanDiscovery::get_device_count() const {
+    return devices_->size();
+}
+
 std::shared_ptr<DeviceInfo> MIoTLanDiscovery::get_device(const std::string& did) const {
-    std::lock_guard<std::mutex> lock(devices_mutex_);
+    uint64_t did_num;
+    if (!parse_did(did, did_num)) {
+        return nullptr;
+    }
     
-    auto it = devices_.find(did);
-    if (it != devices_.end()) {
-        return it->second;
+    auto info = std::make_shared<DeviceInfo>();
+    if (!devices_->find(did_num, *info)) {
+        return nullptr;
     }
-    return nullptr;
+    return info;
 }
 
 void MIoTLanDiscovery::register_callback(const std::string& key, DeviceStatusCallback callback) {
@@ -597,11 +1115,72 @@ void MIoTLanDiscovery::set_scan_intervals(double min_interval, double max_interv
     current_scan_interval_ = min_interval;
 }
 
+void MIoTLanDiscovery::set_keepalive_intervals(double interval, double min_interval) {
+    std::lock_guard<std::mutex> lock(device_timers_mutex_);
+    keepalive_interval_ = interval;
+    min_keepalive_interval_ = min_interval;
+}
+
+void MIoTLanDiscovery::notify_network_changed() {
+    if (!running_) {
+        return;
+    }
+    
+    // Picked up by get_next_scan_interval() after the immediate probe
+    scan_reset_pending_ = true;
+    arm_probe_timer(0);
+}
+
+void MIoTLanDiscovery::set_event_workers(size_t count) {
+    event_dispatcher_.set_worker_count(count);
+}
+
 void MIoTLanDiscovery::set_device_timeout(double timeout) {
+    std::lock_guard<std::mutex> lock(device_timers_mutex_);
     device_timeout_ = timeout;
 }
 
+void MIoTLanDiscovery::set_class_timeout(const std::string& device_class, double timeout) {
+    std::lock_guard<std::mutex> lock(device_timers_mutex_);
+    class_timeouts_[device_class] = timeout;
+}
+
+void MIoTLanDiscovery::set_device_class(const std::string& did, const std::string& device_class) {
+    uint64_t did_num;
+    if (!parse_did(did, did_num)) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(device_timers_mutex_);
+    device_classes_[did_num] = device_class;
+    
+    // Re-time an online device against its new window
+    DeviceInfo info;
+    if (devices_->find(did_num, info) && info.online) {
+        liveness_wheel_->schedule(did_num, info.last_seen + device_timeout_for(did_num));
+        arm_device_timer();
+    }
+}
+
+std::chrono::steady_clock::duration MIoTLanDiscovery::device_timeout_for(uint64_t did) const {
+    // Caller holds device_timers_mutex_
+    auto class_it = device_classes_.find(did);
+    if (class_it != device_classes_.end()) {
+        auto timeout_it = class_timeouts_.find(class_it->second);
+        if (timeout_it != class_timeouts_.end()) {
+            return to_duration(timeout_it->second);
+        }
+    }
+    return to_duration(device_timeout_);
+}
+
 double MIoTLanDiscovery::get_next_scan_interval() {
+    // A network change starts the backoff over
+    if (scan_reset_pending_.exchange(false)) {
+        current_scan_interval_ = min_scan_interval_;
+        return current_scan_interval_;
+    }
+    
     current_scan_interval_ = std::min(current_scan_interval_ * 2.0, max_scan_interval_);
     return current_scan_interval_;
 }
@@ -27,6 +27,79 @@ static size_t write_callback(void* contents, size_t size, size_t nmemb, void* us
     return size * nmemb;
 }
 
+TokenHolder::TokenHolder()
+    : version_(0)
+    , closed_(false) {
+}
+
+uint64_t TokenHolder::set(const TokenInfo& token) {
+    uint64_t version;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        token_ = token;
+        version = ++version_;
+    }
+    cv_.notify_all();
+    return version;
+}
+
+TokenInfo TokenHolder::get(uint64_t* version) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (version) {
+        *version = version_;
+    }
+    return token_;
+}
+
+uint64_t TokenHolder::version() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
+
+bool TokenHolder::wait_valid(TokenInfo& token,
+                             std::chrono::steady_clock::time_point deadline,
+                             uint64_t* version) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_until(lock, deadline, [this]() { return closed_ || token_.is_valid(); });
+    if (!token_.is_valid()) {
+        return false;
+    }
+    token = token_;
+    if (version) {
+        *version = version_;
+    }
+    return true;
+}
+
+bool TokenHolder::wait_newer(uint64_t known_version,
+                             TokenInfo& token,
+                             std::chrono::steady_clock::time_point deadline,
+                             uint64_t* version) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_until(lock, deadline, [this, known_version]() { return closed_ || version_ > known_version; });
+    if (version_ <= known_version) {
+        return false;
+    }
+    token = token_;
+    if (version) {
+        *version = version_;
+    }
+    return true;
+}
+
+void TokenHolder::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = false;
+}
+
+void TokenHolder::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    cv_.notify_all();
+}
+
 MiotOAuth::MiotOAuth(const std::string& client_id, 
                      const std::string& redirect_uri,
                      const std::string& cloud_server,
@@ -34,7 +107,9 @@ MiotOAuth::MiotOAuth(const std::string& client_id,
     : client_id_(client_id)
     , redirect_uri_(redirect_uri)
     , cloud_server_(cloud_server)
-    , token_file_(token_file) {
+    , token_file_(token_file)
+    , http_pool_(HttpClientPool::shared())
+    , next_subscription_id_(1) {
     
     // 设置OAuth服务器地址
     if (cloud_server == "cn") {
@@ -141,17 +216,21 @@ bool MiotOAuth::exchange_code_for_token(const std::string& code, const std::stri
         }
         
         auto result = response_json["result"];
-        token_.access_token = result["access_token"];
-        token_.refresh_token = result["refresh_token"];
+        TokenInfo token;
+        token.access_token = result["access_token"];
+        token.refresh_token = result["refresh_token"];
         
         int expires_in = result["expires_in"];
-        token_.expires_at = std::chrono::system_clock::now() 
-                          + std::chrono::seconds(static_cast<int>(expires_in * 0.7));
+        token.expires_at = std::chrono::system_clock::now() 
+                         + std::chrono::seconds(static_cast<int>(expires_in * 0.7));
+        token_.set(token);
         
         std::cout << "✓ Successfully obtained access token!" << std::endl;
         std::cout << "Token expires in: " << expires_in << " seconds" << std::endl;
         
-        return save_token();
+        bool saved = save_token();
+        notify_token_subscribers(std::chrono::steady_clock::now());
+        return saved;
         
     } catch (const std::exception& e) {
         std::cerr << "Error parsing token response: " << e.what() << std::endl;
@@ -161,7 +240,8 @@ bool MiotOAuth::exchange_code_for_token(const std::string& code, const std::stri
 }
 
 bool MiotOAuth::refresh_token() {
-    if (token_.refresh_token.empty()) {
+    std::string current_refresh_token = token_.get().refresh_token;
+    if (current_refresh_token.empty()) {
         std::cerr << "No refresh token available" << std::endl;
         return false;
     }
@@ -170,12 +250,13 @@ bool MiotOAuth::refresh_token() {
     json request_data = {
         {"client_id", client_id_},
         {"redirect_uri", redirect_uri_},
-        {"refresh_token", token_.refresh_token}
+        {"refresh_token", current_refresh_token}
     };
     
     std::string url = "https://" + oauth_host_ + "/app/v2/mico/oauth/get_token?data=" 
                     + url_encode(request_data.dump());
     
+    auto request_started = std::chrono::steady_clock::now();
     std::string response = http_get(url);
     
     if (response.empty()) {
@@ -192,16 +273,23 @@ bool MiotOAuth::refresh_token() {
         }
         
         auto result = response_json["result"];
-        token_.access_token = result["access_token"];
-        token_.refresh_token = result["refresh_token"];
+        TokenInfo token;
+        token.access_token = result["access_token"];
+        token.refresh_token = result["refresh_token"];
         
         int expires_in = result["expires_in"];
-        token_.expires_at = std::chrono::system_clock::now() 
-                          + std::chrono::seconds(static_cast<int>(expires_in * 0.7));
+        token.expires_at = std::chrono::system_clock::now() 
+                         + std::chrono::seconds(static_cast<int>(expires_in * 0.7));
+        token_.set(token);
         
-        std::cout << "✓ Token refreshed successfully!" << std::endl;
+        auto obtained_at = std::chrono::steady_clock::now();
+        std::cout << "✓ Token refreshed successfully! (request took "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(obtained_at - request_started).count()
+                  << " ms)" << std::endl;
         
-        return save_token();
+        bool saved = save_token();
+        notify_token_subscribers(obtained_at);
+        return saved;
         
     } catch (const std::exception& e) {
         std::cerr << "Error parsing refresh response: " << e.what() << std::endl;
@@ -211,10 +299,11 @@ bool MiotOAuth::refresh_token() {
 
 bool MiotOAuth::save_token(const std::string& filename) const {
     try {
+        TokenInfo token = token_.get();
         json token_json = {
-            {"access_token", token_.access_token},
-            {"refresh_token", token_.refresh_token},
-            {"expires_at", std::chrono::system_clock::to_time_t(token_.expires_at)}
+            {"access_token", token.access_token},
+            {"refresh_token", token.refresh_token},
+            {"expires_at", std::chrono::system_clock::to_time_t(token.expires_at)}
         };
         
         std::ofstream file(filename);
@@ -247,19 +336,21 @@ bool MiotOAuth::load_token(const std::string& filename) {
         file >> token_json;
         file.close();
         
-        token_.access_token = token_json["access_token"];
-        token_.refresh_token = token_json["refresh_token"];
+        TokenInfo token;
+        token.access_token = token_json["access_token"];
+        token.refresh_token = token_json["refresh_token"];
         
         time_t expires_time = token_json["expires_at"];
-        token_.expires_at = std::chrono::system_clock::from_time_t(expires_time);
+        token.expires_at = std::chrono::system_clock::from_time_t(expires_time);
+        token_.set(token);
         
         std::cout << "✓ Token loaded from: " << filename << std::endl;
         
         // 检查是否需要刷新
-        if (token_.is_expired()) {
+        if (token.is_expired()) {
             std::cout << "⚠ Token has expired, need to re-authenticate" << std::endl;
             return false;
-        } else if (token_.needs_refresh()) {
+        } else if (token.needs_refresh()) {
             std::cout << "Token needs refresh, refreshing..." << std::endl;
             return refresh_token();
         }
@@ -274,11 +365,12 @@ bool MiotOAuth::load_token(const std::string& filename) {
 }
 
 bool MiotOAuth::is_token_valid() const {
-    return !token_.access_token.empty() && !token_.is_expired();
+    return token_.get().is_valid();
 }
 
 std::string MiotOAuth::http_get(const std::string& url) const {
-    CURL* curl = curl_easy_init();
+    HttpClientPool::Handle handle = http_pool_->acquire();
+    CURL* curl = handle.get();
     std::string response;
     
     if (curl) {
@@ -294,15 +386,14 @@ std::string MiotOAuth::http_get(const std::string& url) const {
         if (res != CURLE_OK) {
             std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
         }
-        
-        curl_easy_cleanup(curl);
     }
     
     return response;
 }
 
 std::string MiotOAuth::http_post(const std::string& url, const std::string& data) const {
-    CURL* curl = curl_easy_init();
+    HttpClientPool::Handle handle = http_pool_->acquire();
+    CURL* curl = handle.get();
     std::string response;
     
     if (curl) {
@@ -318,17 +409,58 @@ std::string MiotOAuth::http_post(const std::string& url, const std::string& data
         if (res != CURLE_OK) {
             std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
         }
-        
-        curl_easy_cleanup(curl);
     }
     
     return response;
 }
 
+uint64_t MiotOAuth::subscribe_token(TokenCallback callback) {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    uint64_t id = next_subscription_id_++;
+    token_subscribers_[id] = std::move(callback);
+    return id;
+}
+
+void MiotOAuth::unsubscribe_token(uint64_t subscription_id) {
+    std::lock_guard<std::mutex> lock(subscribers_mutex_);
+    token_subscribers_.erase(subscription_id);
+}
+
+void MiotOAuth::notify_token_subscribers(std::chrono::steady_clock::time_point obtained_at) {
+    // 复制一份，回调里可以安全地订阅/取消订阅
+    std::map<uint64_t, TokenCallback> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(subscribers_mutex_);
+        subscribers = token_subscribers_;
+    }
+    if (subscribers.empty()) {
+        return;
+    }
+    
+    TokenInfo token = token_.get();
+    for (const auto& pair : subscribers) {
+        try {
+            pair.second(token);
+        } catch (const std::exception& e) {
+            std::cerr << "[MiotOAuth] Token subscriber " << pair.first << " failed: " << e.what() << std::endl;
+        }
+    }
+    
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - obtained_at);
+    std::cout << "[MiotOAuth] New token propagated to " << subscribers.size()
+              << " subscriber(s) in " << latency.count() / 1000.0 << " ms" << std::endl;
+}
+
 bool MiotOAuth::start_auth_flow() {
 
     should_exit_ = false;
-    token_refresh_thread_ = std::thread([this]() { token_refresh_loop(); });
+    token_.open();
+    token_refresh_thread_ = std::thread([this]() {
+        token_refresh_loop();
+        // 授权失败或退出后，等待token的线程立即返回
+        token_.close();
+    });
 
 
     return true;
@@ -428,12 +560,12 @@ void MiotOAuth::token_refresh_loop() {
     std::cout << "║              ✓ Authorization Successful                    ║\n";
     std::cout << "╚════════════════════════════════════════════════════════════╝\n";
     std::cout << "\n";
-    std::cout << "Access Token: " << token_.access_token.substr(0, 30) << "...\n";
+    std::cout << "Access Token: " << token_.get().access_token.substr(0, 30) << "...\n";
     std::cout << "\n";
     
     // 计算token过期时间
     auto now = std::chrono::system_clock::now();
-    auto expires_at = token_.expires_at;
+    auto expires_at = token_.get().expires_at;
     auto duration = std::chrono::duration_cast<std::chrono::minutes>(expires_at - now);
     std::cout << "Token expires in: " << duration.count() << " minutes\n";
     std::cout << "\n";
@@ -447,7 +579,7 @@ void MiotOAuth::token_refresh_loop() {
     
     int check_count = 0;
     while (!should_exit_) {
-        if (token_.needs_refresh()) {
+        if (token_.get().needs_refresh()) {
             std::cout << "\n[" << ++check_count << "] Token expiring soon, refreshing...\n";
             if (!refresh_token()) {
                 std::cerr << "✗ Failed to refresh token\n";
@@ -457,7 +589,7 @@ void MiotOAuth::token_refresh_loop() {
             
             // 显示新的过期时间
             now = std::chrono::system_clock::now();
-            expires_at = token_.expires_at;
+            expires_at = token_.get().expires_at;
             duration = std::chrono::duration_cast<std::chrono::minutes>(expires_at - now);
             std::cout << "New token expires in: " << duration.count() << " minutes\n";
         }
@@ -471,27 +603,18 @@ void MiotOAuth::token_refresh_loop() {
     std::cout << "\n✓ Program exited gracefully\n\n";
 }
 
-bool MiotOAuth::get_token(TokenInfo& token,std::chrono::seconds timeout) {
-    auto start_time = std::chrono::steady_clock::now();
-    auto end_time = start_time + timeout;
-    
-    while (std::chrono::steady_clock::now() < end_time) {
-        if (is_token_valid()) {
-            token = token_;
-            return true;
-        }
-        
-        // 每100ms检查一次
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-    
-    // 超时，最后再检查一次
-    if (is_token_valid()) {
-        token = token_;
-        return true;
-    }
-    
-    return false;
+bool MiotOAuth::get_token(TokenInfo& token, std::chrono::seconds timeout) {
+    return token_.wait_valid(token, std::chrono::steady_clock::now() + timeout);
+}
+
+uint64_t MiotOAuth::token_version() const {
+    return token_.version();
 }
+
+bool MiotOAuth::wait_token_update(uint64_t known_version, TokenInfo& token,
+                                  std::chrono::milliseconds timeout, uint64_t* version) {
+    return token_.wait_newer(known_version, token, std::chrono::steady_clock::now() + timeout, version);
+}
+
 } // namespace miot
 
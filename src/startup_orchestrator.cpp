@@ -0,0 +1,130 @@
+/**
+ * Startup Orchestrator - Implementation
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "startup_orchestrator.h"
+
+#include <iostream>
+#include <thread>
+
+namespace miot {
+
+namespace {
+
+std::chrono::milliseconds elapsed_ms(std::chrono::steady_clock::time_point from,
+                                     std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from);
+}
+
+} // anonymous namespace
+
+bool StartupOrchestrator::add_stage(const std::string& name,
+                                    const std::vector<std::string>& depends_on,
+                                    Stage stage) {
+    if (index_.count(name)) {
+        std::cerr << "[Startup] Duplicate stage: " << name << std::endl;
+        return false;
+    }
+
+    auto entry = std::make_unique<StageEntry>();
+    entry->name = name;
+    entry->stage = std::move(stage);
+    entry->result = entry->done.get_future().share();
+    entry->timing.name = name;
+
+    // Dependencies must be added first, which also rules out cycles
+    for (const auto& dependency : depends_on) {
+        auto it = index_.find(dependency);
+        if (it == index_.end()) {
+            std::cerr << "[Startup] Stage " << name << " depends on unknown stage " << dependency << std::endl;
+            return false;
+        }
+        entry->depends_on.push_back(it->second);
+    }
+
+    index_[name] = stages_.size();
+    stages_.push_back(std::move(entry));
+    return true;
+}
+
+bool StartupOrchestrator::run() {
+    auto origin = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    threads.reserve(stages_.size());
+    for (auto& entry : stages_) {
+        StageEntry* stage = entry.get();
+        threads.emplace_back([this, stage, origin]() { run_stage(*stage, origin); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool all_succeeded = true;
+    for (const auto& entry : stages_) {
+        all_succeeded = all_succeeded && entry->timing.succeeded;
+    }
+
+    std::cout << "[Startup] " << (all_succeeded ? "All stages done" : "Startup failed")
+              << " in " << elapsed_ms(origin, std::chrono::steady_clock::now()).count() << " ms" << std::endl;
+    return all_succeeded;
+}
+
+void StartupOrchestrator::run_stage(StageEntry& entry, std::chrono::steady_clock::time_point origin) {
+    bool dependencies_ok = true;
+    for (size_t dependency : entry.depends_on) {
+        // Waits only for this stage's own dependencies
+        if (!stages_[dependency]->result.get()) {
+            dependencies_ok = false;
+        }
+    }
+
+    StartupStageTiming timing;
+    timing.name = entry.name;
+
+    if (!dependencies_ok) {
+        timing.skipped = true;
+        timing.started_at = elapsed_ms(origin, std::chrono::steady_clock::now());
+        std::cerr << "[Startup] " << entry.name << " skipped, a dependency failed" << std::endl;
+    } else {
+        auto started = std::chrono::steady_clock::now();
+        try {
+            timing.succeeded = entry.stage();
+        } catch (const std::exception& e) {
+            std::cerr << "[Startup] " << entry.name << " threw: " << e.what() << std::endl;
+        }
+        auto finished = std::chrono::steady_clock::now();
+        timing.started_at = elapsed_ms(origin, started);
+        timing.duration = elapsed_ms(started, finished);
+
+        std::cout << "[Startup] " << entry.name << (timing.succeeded ? " done" : " FAILED")
+                  << " in " << timing.duration.count() << " ms"
+                  << " (started at +" << timing.started_at.count() << " ms)" << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entry.timing = timing;
+    }
+    entry.done.set_value(timing.succeeded);
+}
+
+bool StartupOrchestrator::succeeded(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(name);
+    return it != index_.end() && stages_[it->second]->timing.succeeded;
+}
+
+std::vector<StartupStageTiming> StartupOrchestrator::get_timings() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<StartupStageTiming> timings;
+    for (const auto& entry : stages_) {
+        timings.push_back(entry->timing);
+    }
+    return timings;
+}
+
+} // namespace miot
@@ -0,0 +1,144 @@
+/**
+ * Timer Wheel - Implementation
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+namespace miot {
+
+TimerWheel::TimerWheel(Clock::duration tick, Clock::time_point origin)
+    : tick_(tick),
+      origin_(origin),
+      current_tick_(0),
+      level_entries_{}
+{
+}
+
+void TimerWheel::schedule(uint64_t key, Clock::time_point deadline) {
+    // Round up so a timer never fires early; anything already due goes in the next tick
+    uint64_t deadline_tick = current_tick_ + 1;
+    if (deadline > origin_) {
+        auto offset = deadline - origin_;
+        uint64_t ticks = static_cast<uint64_t>((offset + tick_ - Clock::duration(1)) / tick_);
+        deadline_tick = std::max(ticks, current_tick_ + 1);
+    }
+
+    deadlines_[key] = deadline_tick;
+    place(Timer{key, deadline_tick});
+}
+
+void TimerWheel::cancel(uint64_t key) {
+    deadlines_.erase(key);
+}
+
+void TimerWheel::place(const Timer& timer) {
+    // Deadlines beyond the top level are parked in its furthest slot and re-placed when reached
+    uint64_t delta = std::min(timer.deadline_tick - current_tick_, MAX_DELTA);
+    uint64_t tick = current_tick_ + delta;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    slots_[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK].push_back(timer);
+    level_entries_[level]++;
+}
+
+bool TimerWheel::is_live(const Timer& timer) const {
+    auto it = deadlines_.find(timer.key);
+    return it != deadlines_.end() && it->second == timer.deadline_tick;
+}
+
+void TimerWheel::advance(Clock::time_point now, std::vector<uint64_t>& expired) {
+    if (now < origin_) {
+        return;
+    }
+    uint64_t target = static_cast<uint64_t>((now - origin_) / tick_);
+
+    while (current_tick_ < target) {
+        // Nothing pending: drop stale entries and jump straight to now
+        if (deadlines_.empty()) {
+            for (int level = 0; level < LEVELS && level_entries_[level] > 0; level++) {
+                for (auto& slot : slots_[level]) {
+                    slot.clear();
+                }
+                level_entries_[level] = 0;
+            }
+            current_tick_ = target;
+            break;
+        }
+
+        current_tick_++;
+
+        // Entering a new span of a higher level: move its timers down, top level first
+        int top = 0;
+        while (top < LEVELS - 1 &&
+               (current_tick_ & ((1ULL << (SLOT_BITS * (top + 1))) - 1)) == 0) {
+            top++;
+        }
+        for (int level = top; level > 0; level--) {
+            std::vector<Timer> cascading;
+            cascading.swap(slots_[level][(current_tick_ >> (SLOT_BITS * level)) & SLOT_MASK]);
+            level_entries_[level] -= cascading.size();
+            for (const Timer& timer : cascading) {
+                if (is_live(timer)) {
+                    place(timer);
+                }
+            }
+        }
+
+        std::vector<Timer> due;
+        due.swap(slots_[0][current_tick_ & SLOT_MASK]);
+        level_entries_[0] -= due.size();
+        for (const Timer& timer : due) {
+            if (!is_live(timer)) {
+                continue;
+            }
+            if (timer.deadline_tick > current_tick_) {
+                place(timer);  // Was clamped into the top level
+                continue;
+            }
+            deadlines_.erase(timer.key);
+            expired.push_back(timer.key);
+        }
+    }
+}
+
+bool TimerWheel::next_wakeup(Clock::time_point& when) const {
+    if (deadlines_.empty()) {
+        return false;
+    }
+
+    // The next cascade is due at the start of the next level-1 span
+    uint64_t next_tick = UINT64_MAX;
+    bool upper_levels = false;
+    for (int level = 1; level < LEVELS; level++) {
+        upper_levels = upper_levels || level_entries_[level] > 0;
+    }
+    if (upper_levels) {
+        next_tick = (current_tick_ | SLOT_MASK) + 1;
+    }
+
+    if (level_entries_[0] > 0) {
+        for (uint64_t tick = current_tick_ + 1; tick < current_tick_ + SLOTS && tick < next_tick; tick++) {
+            if (!slots_[0][tick & SLOT_MASK].empty()) {
+                next_tick = tick;
+                break;
+            }
+        }
+    }
+
+    if (next_tick == UINT64_MAX) {
+        return false;
+    }
+    when = origin_ + tick_ * static_cast<Clock::rep>(next_tick);
+    return true;
+}
+
+} // namespace miot
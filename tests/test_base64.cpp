@@ -0,0 +1,126 @@
+/**
+ * Base64 Test
+ *
+ * Runs every kernel usable on this CPU against OpenSSL's EVP_EncodeBlock /
+ * EVP_DecodeBlock for all lengths up to 4096 bytes, and checks that
+ * malformed input is rejected wherever the bad character sits.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "base64.h"
+#include "test_common.h"
+
+#include <openssl/evp.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace miot;
+
+namespace {
+
+const size_t MAX_LEN = 4096;
+
+std::string openssl_encode(const std::vector<uint8_t>& data) {
+    std::string out(Base64::encoded_size(data.size()) + 1, '\0');
+    int len = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(&out[0]), data.data(),
+                              static_cast<int>(data.size()));
+    out.resize(static_cast<size_t>(len));
+    return out;
+}
+
+// EVP_DecodeBlock keeps the zero bytes produced by '=' padding; strip them
+bool openssl_decode(const std::string& encoded, std::vector<uint8_t>& out) {
+    out.resize(Base64::decoded_max_size(encoded.size()) + 1);
+    int len = EVP_DecodeBlock(out.data(), reinterpret_cast<const unsigned char*>(encoded.data()),
+                              static_cast<int>(encoded.size()));
+    if (len < 0) {
+        out.clear();
+        return false;
+    }
+    size_t padding = 0;
+    for (size_t i = encoded.size(); i > 0 && encoded[i - 1] == '=' && padding < 2; i--) {
+        padding++;
+    }
+    out.resize(static_cast<size_t>(len) - padding);
+    return true;
+}
+
+void test_round_trip(std::mt19937& rng) {
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> decoded;
+    std::vector<uint8_t> expected;
+
+    for (size_t len = 0; len <= MAX_LEN; len++) {
+        data.resize(len);
+        for (auto& b : data) {
+            b = static_cast<uint8_t>(byte(rng));
+        }
+
+        std::string encoded = Base64::encode(data.data(), data.size());
+        std::string reference = openssl_encode(data);
+        CHECK_MSG(encoded == reference, "encode mismatch at len " << len);
+
+        CHECK_MSG(Base64::decode(reference, decoded), "decode failed at len " << len);
+        CHECK_MSG(openssl_decode(reference, expected) && decoded == expected && decoded == data,
+                  "decode mismatch at len " << len);
+
+        // Padding is optional and trailing whitespace is ignored
+        std::string unpadded = reference;
+        while (!unpadded.empty() && unpadded.back() == '=') {
+            unpadded.pop_back();
+        }
+        CHECK_MSG(Base64::decode(unpadded + "\r\n", decoded) && decoded == data,
+                  "unpadded decode mismatch at len " << len);
+    }
+}
+
+void test_invalid_input(std::mt19937& rng) {
+    const char bad_chars[] = {'*', '-', '_', '.', '=', ' ', '\0', '\x80', '\xff'};
+    std::vector<uint8_t> decoded;
+
+    for (size_t len : {3, 12, 48, 96, 300, 3072}) {
+        std::vector<uint8_t> data(len);
+        for (size_t i = 0; i < len; i++) {
+            data[i] = static_cast<uint8_t>(rng());
+        }
+        std::string encoded = Base64::encode(data.data(), data.size());
+
+        // One bad character at each position: leading, inside SIMD blocks, in the tail
+        std::uniform_int_distribution<size_t> position(0, encoded.size() - 3);
+        for (char bad : bad_chars) {
+            for (size_t pos : {size_t(0), position(rng), position(rng), encoded.size() - 3}) {
+                std::string corrupted = encoded;
+                corrupted[pos] = bad;
+                CHECK_MSG(!Base64::decode(corrupted, decoded),
+                          "accepted 0x" << std::hex << (static_cast<int>(bad) & 0xFF) << std::dec
+                                        << " at " << pos << " of " << corrupted.size());
+                CHECK(decoded.empty());
+            }
+        }
+    }
+
+    // A single leftover character cannot encode any byte
+    CHECK(!Base64::decode("QUJDR", decoded));
+    CHECK(!Base64::decode("Q", decoded));
+    CHECK(Base64::decode("", decoded) && decoded.empty());
+}
+
+} // anonymous namespace
+
+int main() {
+    for (const char* name : Base64::implementations()) {
+        CHECK_MSG(Base64::set_implementation(name), name);
+        std::cout << "Testing base64 kernel: " << Base64::implementation() << std::endl;
+
+        std::mt19937 rng(20250101);
+        test_round_trip(rng);
+        test_invalid_input(rng);
+    }
+    CHECK(!Base64::set_implementation("unknown"));
+    return test::result();
+}
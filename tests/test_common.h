@@ -0,0 +1,51 @@
+/**
+ * Test Helpers
+ *
+ * Assertion macros for the test_* executables: a failed check is reported
+ * with its location and the executable exits non-zero at the end.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <iostream>
+
+namespace miot {
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+/**
+ * @brief Exit code for main: 0 if every check passed
+ */
+inline int result() {
+    if (failures() > 0) {
+        std::cerr << failures() << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
+
+} // namespace test
+} // namespace miot
+
+// Record a failure (with an optional streamed message) and keep going
+#define CHECK_MSG(cond, msg)                                                    \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            miot::test::failures()++;                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") "   \
+                      << msg << std::endl;                                      \
+        }                                                                       \
+    } while (0)
+
+#define CHECK(cond) CHECK_MSG(cond, "")
+
+#endif // TEST_COMMON_H
@@ -0,0 +1,321 @@
+/**
+ * Device List Parser Test
+ *
+ * Feeds synthetic device_list_page responses to the single-pass scanner
+ * (SimpleJson::parse_device_list_response) and to nlohmann::json, and checks
+ * that every CloudDeviceInfo field comes out the same: escaped names and
+ * surrogate pairs, numeric IDs, nested extra/owner objects and decoy keys.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "miot_cloud_client.h"
+#include "test_common.h"
+
+#include <nlohmann/json.hpp>
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <map>
+
+using namespace miot;
+
+namespace {
+
+// Random text mixing ASCII, characters that must be escaped, and BMP/astral code points
+std::u32string random_text(std::mt19937& rng) {
+    static const char32_t pool[] = {
+        U'a', U'Z', U'0', U' ', U'"', U'\\', U'/', U'\n', U'\t', U'\b', U'\f', U'\r',
+        U'\x01', U'\x1f', U'\x7f', U'é', U'中', U'文', U' ', U'￿',
+        U'\U0001F600', U'\U0001F4F7', U'\U00010000', U'\U0010FFFF',
+    };
+    std::uniform_int_distribution<size_t> length(0, 12);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(pool) / sizeof(pool[0]) - 1);
+    std::u32string text(length(rng), U'a');
+    for (auto& c : text) {
+        c = pool[pick(rng)];
+    }
+    return text;
+}
+
+void append_escape_u(std::string& out, unsigned unit) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "\\u%04x", unit);
+    out += buf;
+}
+
+void append_utf8(std::string& out, char32_t c) {
+    if (c < 0x80) {
+        out += static_cast<char>(c);
+    } else if (c < 0x800) {
+        out += static_cast<char>(0xC0 | (c >> 6));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        out += static_cast<char>(0xE0 | (c >> 12));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (c >> 18));
+        out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (c & 0x3F));
+    }
+}
+
+// JSON string literal; non-ASCII is randomly written raw or as \u escapes (surrogate pairs above the BMP)
+std::string quote(const std::u32string& text, std::mt19937& rng) {
+    std::string out = "\"";
+    for (char32_t c : text) {
+        bool escape = rng() & 1;
+        switch (c) {
+            case U'"': out += "\\\""; continue;
+            case U'\\': out += "\\\\"; continue;
+            case U'\n': out += escape ? "\\n" : "\\u000a"; continue;
+            case U'\t': out += "\\t"; continue;
+            case U'\b': out += "\\b"; continue;
+            case U'\f': out += "\\f"; continue;
+            case U'\r': out += "\\r"; continue;
+            case U'/': out += escape ? "\\/" : "/"; continue;
+            default: break;
+        }
+        if (c < 0x20) {
+            append_escape_u(out, c);
+        } else if (c < 0x80 || !escape) {
+            append_utf8(out, c);
+        } else if (c < 0x10000) {
+            append_escape_u(out, c);
+        } else {
+            char32_t v = c - 0x10000;
+            append_escape_u(out, 0xD800 + (v >> 10));
+            append_escape_u(out, 0xDC00 + (v & 0x3FF));
+        }
+    }
+    return out + "\"";
+}
+
+std::string quote(const std::string& ascii, std::mt19937& rng) {
+    return quote(std::u32string(ascii.begin(), ascii.end()), rng);
+}
+
+// Skipped values the scanner must step over without picking anything up
+std::string decoy_value(std::mt19937& rng) {
+    switch (rng() % 5) {
+        case 0: return "{\"fw_version\":\"decoy\",\"list\":[{\"did\":\"0\",\"model\":\"a.b\"}]}";
+        case 1: return "[1,-2.5e3,true,null,{\"name\":\"decoy\"},[[]]]";
+        case 2: return "-0.125";
+        case 3: return quote(random_text(rng), rng);
+        default: return "null";
+    }
+}
+
+std::string make_device(std::mt19937& rng, uint64_t did) {
+    std::vector<std::string> members;
+    bool numeric_did = rng() % 4 == 0;
+    members.push_back("\"did\":" + (numeric_did ? std::to_string(did) : "\"" + std::to_string(did) + "\""));
+    members.push_back("\"name\":" + quote(random_text(rng), rng));
+    members.push_back("\"model\":\"" + std::string(rng() % 2 ? "xiaomi" : "chuangmi") + ".camera.v" +
+                      std::to_string(rng() % 100) + "\"");
+    members.push_back("\"spec_type\":\"urn:miot-spec-v2:device:camera:0000A01C:" + std::to_string(rng() % 10) + "\"");
+    members.push_back("\"token\":" + quote(random_text(rng), rng));
+    members.push_back("\"uid\":" + (rng() % 2 ? std::to_string(rng()) : "\"" + std::to_string(rng()) + "\""));
+    members.push_back(std::string("\"isOnline\":") + (rng() % 2 ? "true" : "false"));
+    members.push_back("\"local_ip\":\"192.168." + std::to_string(rng() % 256) + "." + std::to_string(rng() % 256) + "\"");
+    members.push_back("\"ssid\":" + (rng() % 5 == 0 ? std::string("null") : quote(random_text(rng), rng)));
+    members.push_back("\"bssid\":\"AA:BB:CC:DD:EE:" + std::to_string(10 + rng() % 90) + "\"");
+    members.push_back("\"rssi\":" + std::to_string(-static_cast<int>(rng() % 100)));
+    members.push_back("\"fw_version\":\"device-level-decoy\"");
+    members.push_back("\"prop\":" + decoy_value(rng));
+
+    if (rng() % 5 != 0) {
+        std::vector<std::string> extra;
+        extra.push_back("\"fw_version\":" + quote("4.1." + std::to_string(rng() % 1000) + "_" + std::to_string(rng() % 10), rng));
+        extra.push_back("\"mcu_version\":" + quote(std::to_string(rng() % 10000), rng));
+        extra.push_back("\"platform\":" + quote(rng() % 2 ? "ingenic" : "", rng));
+        extra.push_back("\"isSetPincode\":" + std::to_string(rng() % 2));
+        extra.push_back("\"pincodeType\":" + std::to_string(rng() % 3));
+        extra.push_back("\"ota\":{\"fw_version\":\"nested-decoy\",\"steps\":[1,2]}");
+        std::shuffle(extra.begin(), extra.end(), rng);
+
+        std::string object = "{";
+        for (size_t i = 0; i < extra.size(); i++) {
+            object += (i ? ",\n  " : "") + extra[i];
+        }
+        members.push_back("\"extra\":" + object + "}");
+    }
+    if (rng() % 3 != 0) {
+        members.push_back("\"owner\":{\"userid\":" + std::to_string(rng()) +
+                          ",\"nickname\":" + quote(random_text(rng), rng) + ",\"icon\":\"\"}");
+    }
+    std::shuffle(members.begin(), members.end(), rng);
+
+    std::string object = "{";
+    for (size_t i = 0; i < members.size(); i++) {
+        object += (i ? ", " : "") + members[i];
+    }
+    return object + "}";
+}
+
+std::string make_response(std::mt19937& rng, size_t device_count, uint64_t& next_did) {
+    std::string list;
+    for (size_t i = 0; i < device_count; i++) {
+        list += (i ? ",\n" : "") + make_device(rng, next_did++);
+    }
+    return "{\"code\":0,\"message\":\"ok\",\"result\":{\"meta\":{\"list\":\"not-this-one\"},"
+           "\"list\":[" + list + "],\"has_more\":false,\"next_start_did\":\"\"}}";
+}
+
+// Reference extraction: same field mapping, done on the nlohmann DOM
+std::string id_string(const nlohmann::json& value) {
+    return value.is_string() ? value.get<std::string>() : std::to_string(value.get<int64_t>());
+}
+
+int int_value(const nlohmann::json& value) {
+    return value.is_boolean() ? (value.get<bool>() ? 1 : 0) : value.get<int>();
+}
+
+void copy_string(const nlohmann::json& object, const char* key, std::string& target) {
+    auto it = object.find(key);
+    if (it != object.end() && !it->is_null()) {
+        target = it->is_string() ? it->get<std::string>() : id_string(*it);
+    }
+}
+
+std::map<std::string, CloudDeviceInfo> reference_parse(const std::string& json) {
+    std::map<std::string, CloudDeviceInfo> devices;
+    nlohmann::json document = nlohmann::json::parse(json);
+    for (const auto& item : document["result"]["list"]) {
+        CloudDeviceInfo info;
+        copy_string(item, "did", info.did);
+        copy_string(item, "name", info.name);
+        copy_string(item, "model", info.model);
+        copy_string(item, "spec_type", info.urn);
+        copy_string(item, "token", info.token);
+        copy_string(item, "uid", info.uid);
+        copy_string(item, "local_ip", info.local_ip);
+        copy_string(item, "ssid", info.ssid);
+        copy_string(item, "bssid", info.bssid);
+        info.online = item.value("isOnline", false);
+        info.rssi = item.value("rssi", 0);
+
+        auto extra = item.find("extra");
+        if (extra != item.end() && extra->is_object()) {
+            copy_string(*extra, "fw_version", info.fw_version);
+            copy_string(*extra, "mcu_version", info.mcu_version);
+            copy_string(*extra, "platform", info.platform);
+            if (extra->contains("isSetPincode")) {
+                info.is_set_pincode = int_value((*extra)["isSetPincode"]);
+            }
+            if (extra->contains("pincodeType")) {
+                info.pincode_type = int_value((*extra)["pincodeType"]);
+            }
+        }
+        auto owner = item.find("owner");
+        if (owner != item.end() && owner->is_object()) {
+            copy_string(*owner, "userid", info.owner_id);
+            copy_string(*owner, "nickname", info.owner_nickname);
+        }
+
+        if (info.did.empty() || info.model.empty()) {
+            continue;
+        }
+        info.manufacturer = info.model.substr(0, info.model.find('.'));
+        devices[info.did] = info;
+    }
+    return devices;
+}
+
+void check_same(const CloudDeviceInfo& got, const CloudDeviceInfo& want) {
+#define CHECK_FIELD(field) CHECK_MSG(got.field == want.field, "did " << want.did << " " #field ": \"" \
+                                     << got.field << "\" != \"" << want.field << "\"")
+    CHECK_FIELD(did);
+    CHECK_FIELD(name);
+    CHECK_FIELD(model);
+    CHECK_FIELD(urn);
+    CHECK_FIELD(manufacturer);
+    CHECK_FIELD(token);
+    CHECK_FIELD(uid);
+    CHECK_FIELD(online);
+    CHECK_FIELD(local_ip);
+    CHECK_FIELD(ssid);
+    CHECK_FIELD(bssid);
+    CHECK_FIELD(rssi);
+    CHECK_FIELD(fw_version);
+    CHECK_FIELD(mcu_version);
+    CHECK_FIELD(platform);
+    CHECK_FIELD(is_set_pincode);
+    CHECK_FIELD(pincode_type);
+    CHECK_FIELD(owner_id);
+    CHECK_FIELD(owner_nickname);
+    CHECK_FIELD(home_id);
+    CHECK_FIELD(home_name);
+    CHECK_FIELD(room_id);
+    CHECK_FIELD(room_name);
+#undef CHECK_FIELD
+}
+
+void test_random_responses() {
+    std::mt19937 rng(42);
+    uint64_t next_did = 100000000;
+    size_t compared = 0;
+    for (int round = 0; round < 500; round++) {
+        std::string json = make_response(rng, rng() % 40, next_did);
+        auto got = SimpleJson::parse_device_list_response(json);
+        auto want = reference_parse(json);
+
+        CHECK_MSG(got.size() == want.size(), "round " << round << ": " << got.size() << " vs " << want.size());
+        for (const auto& entry : want) {
+            auto it = got.find(entry.first);
+            CHECK_MSG(it != got.end(), "round " << round << ": missing did " << entry.first);
+            if (it != got.end()) {
+                check_same(it->second, entry.second);
+                compared++;
+            }
+        }
+    }
+    CHECK_MSG(compared > 5000, "only " << compared << " devices compared");
+}
+
+void test_known_values() {
+    // Hand-written escapes, so the expectation does not depend on either parser
+    std::string json = R"({"result":{"list":[{"did":"1001","model":"xiaomi.camera.082ac1",)"
+                       R"("name":"Say \"hi\" \\ é😀","uid":12345678901,)"
+                       R"("extra":{"fw_version":"4.1.6_1999","ota":{"fw_version":"x"}},)"
+                       R"("owner":{"userid":42,"nickname":"中文"}}]}})";
+    auto devices = SimpleJson::parse_device_list_response(json);
+    CHECK(devices.size() == 1);
+    const CloudDeviceInfo& info = devices["1001"];
+    CHECK(info.name == "Say \"hi\" \\ \xc3\xa9\xf0\x9f\x98\x80");
+    CHECK(info.uid == "12345678901");
+    CHECK(info.manufacturer == "xiaomi");
+    CHECK(info.fw_version == "4.1.6_1999");
+    CHECK(info.owner_id == "42");
+    CHECK(info.owner_nickname == "\xe4\xb8\xad\xe6\x96\x87");
+}
+
+void test_malformed() {
+    // Devices before the error are kept; nothing is read past it
+    uint64_t next_did = 1;
+    std::mt19937 rng(7);
+    std::string json = make_response(rng, 5, next_did);
+    for (size_t cut = 0; cut < json.size(); cut += 7) {
+        // The parser logs every error to std::cerr; keep it out of the test output
+        std::ostringstream log;
+        std::streambuf* saved = std::cerr.rdbuf(log.rdbuf());
+        auto devices = SimpleJson::parse_device_list_response(json.substr(0, cut));
+        std::cerr.rdbuf(saved);
+
+        CHECK(devices.size() <= 5);
+        CHECK_MSG(log.str().find("[SimpleJson]") != std::string::npos, "no error logged at cut " << cut);
+    }
+}
+
+} // anonymous namespace
+
+int main() {
+    test_known_values();
+    test_random_responses();
+    test_malformed();
+    return test::result();
+}
@@ -0,0 +1,230 @@
+/**
+ * Timer Wheel Test
+ *
+ * Checks that deadlines fire on their tick across the level-1 and level-2
+ * boundaries and beyond MAX_DELTA, that rescheduling and cancelling win over
+ * stale slot entries, and that next_wakeup() never sleeps past a deadline.
+ *
+ * Copyright (C) 2025
+ * Licensed under MIT License
+ */
+
+#include "timer_wheel.h"
+#include "test_common.h"
+
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace miot;
+
+namespace {
+
+using Clock = TimerWheel::Clock;
+
+const Clock::duration TICK = std::chrono::milliseconds(100);
+const Clock::time_point ORIGIN = Clock::time_point() + std::chrono::hours(1);
+
+// Level spans in ticks, matching the wheel's 256 slots per level
+const uint64_t LEVEL1 = 256;
+const uint64_t LEVEL2 = 256 * 256;
+const uint64_t MAX_DELTA = 256 * 256 * 256 - 1;
+
+Clock::time_point at(uint64_t tick) {
+    return ORIGIN + TICK * static_cast<Clock::rep>(tick);
+}
+
+// Advance one tick at a time and record the tick each key fired on
+std::map<uint64_t, uint64_t> run(TimerWheel& wheel, uint64_t from, uint64_t to) {
+    std::map<uint64_t, uint64_t> fired;
+    std::vector<uint64_t> expired;
+    for (uint64_t tick = from; tick <= to; tick++) {
+        expired.clear();
+        wheel.advance(at(tick), expired);
+        for (uint64_t key : expired) {
+            CHECK_MSG(fired.emplace(key, tick).second, "key " << key << " fired twice");
+        }
+    }
+    return fired;
+}
+
+void test_level_boundaries() {
+    const uint64_t deadlines[] = {
+        1, 2, LEVEL1 - 1, LEVEL1, LEVEL1 + 1, 2 * LEVEL1, 2 * LEVEL1 + 7,
+        LEVEL2 - 1, LEVEL2, LEVEL2 + 1, LEVEL2 + LEVEL1, 3 * LEVEL2 + 12345,
+    };
+
+    TimerWheel wheel(TICK, ORIGIN);
+    for (uint64_t deadline : deadlines) {
+        wheel.schedule(deadline, at(deadline));
+    }
+    CHECK(wheel.size() == sizeof(deadlines) / sizeof(deadlines[0]));
+
+    auto fired = run(wheel, 0, 4 * LEVEL2);
+    for (uint64_t deadline : deadlines) {
+        CHECK_MSG(fired.count(deadline) && fired[deadline] == deadline,
+                  "deadline " << deadline << " fired at "
+                              << (fired.count(deadline) ? fired[deadline] : 0));
+    }
+    CHECK(wheel.size() == 0);
+
+    // A deadline between ticks rounds up, one already due fires on the next tick
+    TimerWheel rounding(TICK, ORIGIN);
+    std::vector<uint64_t> expired;
+    rounding.advance(at(10), expired);
+    rounding.schedule(1, at(20) + std::chrono::milliseconds(1));
+    rounding.schedule(2, at(5));
+    auto rounded = run(rounding, 11, 30);
+    CHECK(rounded[1] == 21);
+    CHECK(rounded[2] == 11);
+}
+
+void test_reschedule_and_cancel() {
+    TimerWheel wheel(TICK, ORIGIN);
+
+    // Moved earlier, moved later across levels, cancelled, cancelled then rescheduled
+    wheel.schedule(1, at(LEVEL2 + 10));
+    wheel.schedule(1, at(50));
+    wheel.schedule(2, at(50));
+    wheel.schedule(2, at(LEVEL1 + 3));
+    wheel.schedule(3, at(LEVEL1 + 3));
+    wheel.cancel(3);
+    wheel.schedule(4, at(100));
+    wheel.cancel(4);
+    wheel.schedule(4, at(LEVEL2 + 10));
+    wheel.cancel(99);  // Never scheduled
+    CHECK(wheel.size() == 3);
+
+    auto fired = run(wheel, 0, 2 * LEVEL2);
+    CHECK(fired.size() == 3);
+    CHECK(fired[1] == 50);
+    CHECK(fired[2] == LEVEL1 + 3);
+    CHECK(fired.count(3) == 0);
+    CHECK(fired[4] == LEVEL2 + 10);
+
+    // Random model check: every key fires exactly on the deadline the reference map holds for it
+    std::mt19937 rng(20250101);
+    std::uniform_int_distribution<uint64_t> spread(0, 3 * LEVEL2);
+    TimerWheel random_wheel(TICK, ORIGIN);
+    std::map<uint64_t, uint64_t> live;
+    std::vector<uint64_t> expired;
+
+    const uint64_t KEYS = 2000;
+    for (uint64_t key = 0; key < KEYS; key++) {
+        uint64_t deadline = 1 + spread(rng);
+        random_wheel.schedule(key, at(deadline));
+        live[key] = deadline;
+    }
+
+    for (uint64_t tick = 1; tick <= 4 * LEVEL2; tick++) {
+        expired.clear();
+        random_wheel.advance(at(tick), expired);
+        for (uint64_t key : expired) {
+            auto it = live.find(key);
+            CHECK_MSG(it != live.end() && it->second == tick,
+                      "key " << key << " fired at " << tick << ", expected "
+                             << (it != live.end() ? it->second : 0));
+            if (it != live.end()) {
+                live.erase(it);
+            }
+        }
+
+        // Stop changing deadlines early enough for the last ones to fire within the loop
+        if (tick % 97 == 0 && tick <= 3 * LEVEL2) {
+            uint64_t key = rng() % KEYS;
+            if (rng() % 3 == 0) {
+                random_wheel.cancel(key);
+                live.erase(key);
+            } else {
+                uint64_t deadline = tick + 1 + spread(rng) / 4;
+                random_wheel.schedule(key, at(deadline));
+                live[key] = deadline;
+            }
+        }
+        CHECK(random_wheel.size() == live.size());
+    }
+    CHECK_MSG(live.empty(), live.size() << " key(s) never fired");
+}
+
+void test_clamped_deadline() {
+    TimerWheel wheel(TICK, ORIGIN);
+    const uint64_t far = MAX_DELTA + 3 * LEVEL2 + 17;
+    wheel.schedule(1, at(far));
+    wheel.schedule(2, at(MAX_DELTA));
+
+    std::vector<uint64_t> expired;
+    wheel.advance(at(MAX_DELTA - 1), expired);
+    CHECK(expired.empty());
+    wheel.advance(at(MAX_DELTA), expired);
+    CHECK(expired.size() == 1 && expired[0] == 2);
+
+    expired.clear();
+    wheel.advance(at(far - 1), expired);
+    CHECK(expired.empty());
+    CHECK(wheel.size() == 1);
+    wheel.advance(at(far), expired);
+    CHECK(expired.size() == 1 && expired[0] == 1);
+    CHECK(wheel.size() == 0);
+
+    // Parked in the furthest slot more than once before it is due
+    const uint64_t very_far = far + 2 * MAX_DELTA + 5;
+    wheel.schedule(3, at(very_far));
+    expired.clear();
+    wheel.advance(at(very_far - 1), expired);
+    CHECK(expired.empty());
+    wheel.advance(at(very_far), expired);
+    CHECK(expired.size() == 1 && expired[0] == 3);
+}
+
+void test_next_wakeup() {
+    TimerWheel wheel(TICK, ORIGIN);
+    Clock::time_point when;
+    CHECK(!wheel.next_wakeup(when));
+
+    wheel.schedule(10, at(10));
+    CHECK(wheel.next_wakeup(when) && when == at(10));
+
+    // Sleeping from wakeup to wakeup reaches every deadline on time and never overshoots
+    const uint64_t deadlines[] = {10, LEVEL1 + 1, LEVEL2 + 5, MAX_DELTA + LEVEL1};
+    for (uint64_t deadline : deadlines) {
+        wheel.schedule(deadline, at(deadline));
+    }
+
+    size_t wakeups = 0;
+    size_t fired = 0;
+    Clock::time_point now = ORIGIN;
+    std::vector<uint64_t> expired;
+    while (wheel.next_wakeup(when)) {
+        CHECK(when > now);
+        now = when;
+        wakeups++;
+
+        expired.clear();
+        wheel.advance(now, expired);
+        for (uint64_t key : expired) {
+            CHECK_MSG(at(key) == now, "key " << key << " fired late");
+            fired++;
+        }
+    }
+    CHECK(fired == sizeof(deadlines) / sizeof(deadlines[0]));
+    CHECK(wheel.size() == 0);
+
+    // Cascades need a wakeup per level-1 span, not per tick
+    CHECK_MSG(wakeups <= MAX_DELTA / LEVEL1 + 2 * LEVEL1 + 8, wakeups << " wakeups");
+
+    // Cancelling the only timer leaves nothing to wake up for
+    wheel.schedule(7, at(MAX_DELTA + 2 * LEVEL1));
+    CHECK(wheel.next_wakeup(when));
+    wheel.cancel(7);
+    CHECK(!wheel.next_wakeup(when));
+}
+
+} // anonymous namespace
+
+int main() {
+    test_level_boundaries();
+    test_reschedule_and_cancel();
+    test_clamped_deadline();
+    test_next_wakeup();
+    return test::result();
+}